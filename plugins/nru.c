@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "policy.h"
+
+/**
+ * not recently used, an example policy module
+ * evicts from the lowest class of referenced and modified bits, the oldest page first within it
+ * @type: page table type
+ * @vpt: page table the pages are looked up in
+ * @pages: base virtual addresses of the resident pages, oldest first
+ * @count: number of resident pages
+ * @evictions: pages evicted per class, class 0 is neither referenced nor modified
+ */
+typedef struct nru
+{
+  PAGETABLE type;
+  void *vpt;
+  uint16_t *pages;
+  int count;
+  unsigned long evictions[4];
+} nru;
+
+static void *nru_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  nru *state = (nru *)calloc(1, sizeof(nru));
+  state->type = type;
+  state->vpt = vpt;
+  // merged frames let more pages than frames be resident
+  state->pages = (uint16_t *)malloc(sizeof(uint16_t) * PAGES);
+  return state;
+}
+
+static void nru_destroy(void *state)
+{
+  nru *n = (nru *)state;
+  free(n->pages);
+  free(n);
+}
+
+static int nru_choose_victim(void *state)
+{
+  nru *n = (nru *)state;
+  if (n->count == 0)
+    return -1;
+  int victim = 0;
+  int lowest = 4;
+  for (int i = 0; i < n->count && lowest > 0; i++)
+  {
+    int class = 2 * isreferenced_pte(n->type, n->vpt, n->pages[i]) + ismodified_pte(n->type, n->vpt, n->pages[i]);
+    if (class < lowest)
+    {
+      lowest = class;
+      victim = i;
+    }
+  }
+  uint16_t virtualaddr = n->pages[victim];
+  for (int i = victim; i < n->count - 1; i++)
+    n->pages[i] = n->pages[i + 1];
+  n->count--;
+  n->evictions[lowest]++;
+  return virtualaddr;
+}
+
+static void nru_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  nru *n = (nru *)state;
+  n->pages[n->count++] = virtualaddr & 0xffc0;
+}
+
+static void nru_print_stats(const void *state)
+{
+  const nru *n = (const nru *)state;
+  printf("nru evictions by class: %lu clean, %lu modified, %lu referenced, %lu referenced and modified\n",
+         n->evictions[0],
+         n->evictions[1],
+         n->evictions[2],
+         n->evictions[3]);
+}
+
+const replacementpolicy memsim_policy = {
+    .name = "NRU",
+    .create = nru_create,
+    .destroy = nru_destroy,
+    .choose_victim = nru_choose_victim,
+    .on_load = nru_on_load,
+    .print_stats = nru_print_stats};
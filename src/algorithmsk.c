@@ -10,12 +10,6 @@
 
 #define MEMSIM_ASSERTIONS
 
-struct pagereplacement
-{
-  algonode *evictednode;
-  uint16_t inmemoryoffset;
-};
-
 /**
  * Below are small utilty functions forward declarations
  */
@@ -32,771 +26,2692 @@ void writetopage(
     uint16_t virtualaddr,
     uint8_t value);
 
+// cleanpage: writes back the page at virtualaddr if it is modified, returns true if it did
+bool cleanpage(
+    PAGETABLE type,
+    void *vpt,
+    uint16_t virtualaddr,
+    page *frame,
+    uint16_t framenumber,
+    swapspace *ss,
+    subpage *sp,
+    framehash *fh);
+
 // onunloadpage: call this function on page out
 void onunloadpage(
-    ALGO algo,
-    void *pagereplacer,
+    PAGETABLE type,
+    void *vpt,
     uint16_t virtualaddr,
     page *frame,
-    swapspace *ss);
+    uint16_t framenumber,
+    swapspace *ss,
+    subpage *sp,
+    framehash *fh);
 
 /**
  * Below are forward declarations for each page replacement algorithm
+ * run_eviction_* takes the victim picked by the algorithm out of its list,
+ * the built-in policies at the end of this file call them from their choose_victim hook
  */
-struct pagereplacement run_pagereplacement(ALGO algo, void *pagereplacer, uint16_t virtualaddr, pagetableentry *pte_ref);
-struct pagereplacement run_pagereplacement_fifo(fifo *fifolist, uint16_t virtualaddr, pagetableentry *pte_ref);
-struct pagereplacement run_pagereplacement_sclock(sclock *sclocklist, uint16_t virtualaddr, pagetableentry *pte_ref);
-struct pagereplacement run_pagereplacement_eclock(eclock *eclocklist, uint16_t virtualaddr, pagetableentry *pte_ref);
-struct pagereplacement run_pagereplacement_lru(lru *lrulist, uint16_t virtualaddr, pagetableentry *pte_ref);
+algonode *run_eviction_fifo(fifo *fifolist);
+algonode *run_eviction_sclock(sclock *sclocklist);
+algonode *run_eviction_eclock(eclock *eclocklist);
+algonode *run_eviction_lru(lru *lrulist);
+algonode *run_eviction_opt(opt *optheap);
+int run_eviction_arc(arc *arclist);
+int run_eviction_clockpro(clockpro *clock);
+int run_eviction_mglru(mglru *gens);
+int run_eviction_aging(aging *counters);
+int run_eviction_wsclock(wsclock *ws);
+int run_eviction_lfu(lfu *freqs);
+int run_eviction_adaptive(adaptive *duel);
+
+// writeback_scheduled: writes back the pages a policy scheduled, they stay resident and are clean from now on
+static void writeback_scheduled(
+    PAGETABLE type,
+    void *vpt,
+    const uint16_t *scheduled,
+    const int count,
+    page *memory,
+    swapspace *ss,
+    subpage *sp,
+    framehash *fh)
+{
+  for (int i = 0; i < count; i++)
+  {
+    uint16_t virtualaddr = scheduled[i];
+    if (!isvalid_pte(type, vpt, virtualaddr))
+    {
+      continue;
+    }
+    uint16_t framenumber = get_framenumber(type, vpt, virtualaddr);
+    cleanpage(type, vpt, virtualaddr, memory + framenumber, framenumber, ss, sp, fh);
+    unset_modifiedpte(type, vpt, virtualaddr);
+    if (fh != NULL)
+    {
+      // swap now holds what the frame holds
+      framehash_onload(fh, framenumber, memory + framenumber);
+    }
+  }
+}
+
+// reclaimframes: evicts the pages picked by the page replacer until target frames are free
+struct reclaimresult reclaimframes(
+    replacer *pagereplacer,
+    page *memory,
+    framepool *frames,
+    swapspace *ss,
+    standby *sb,
+    subpage *sp,
+    framehash *fh,
+    const int target)
+{
+  struct reclaimresult result = {.evictions = 0, .evictedVA = 0};
+  PAGETABLE type = pagereplacer->type;
+  void *vpt = pagereplacer->vpt;
+  uint16_t scheduled[PAGES];
+  // a merged frame is only free once every page mapped to it is gone
+  while (frames->nfree < target)
+  {
+    int victim = replacer_choosevictim(pagereplacer);
+    int count = replacer_writebacks(pagereplacer, scheduled);
+    if (count > 0)
+    {
+      writeback_scheduled(type, vpt, scheduled, count, memory, ss, sp, fh);
+      if (victim == -1)
+      {
+        // the policy only scheduled writebacks, its next pick finds those pages clean
+        continue;
+      }
+    }
+    if (victim == -1)
+    {
+      // nothing left to evict
+      break;
+    }
+    uint16_t framenumber = get_framenumber(type, vpt, victim);
+    // call the onunloadpage listener
+    onunloadpage(
+        type,
+        vpt,
+        victim,
+        memory + framenumber,
+        framenumber,
+        ss,
+        sp,
+        fh);
+    if (unmap_frame(frames, framenumber, SS_PAGEIDX(victim)) && sb != NULL)
+    {
+      // clean from here on, the frame keeps its contents until it is acquired again
+      standby_insert(sb, SS_PAGEIDX(victim), framenumber);
+    }
+    replacer_onevict(pagereplacer, victim);
+    result.evictions++;
+    result.evictedVA = victim;
+  }
+  return result;
+}
 
 struct pagefaultresult handlepagefault(
-    ALGO algo,
-    void *pagereplacer,
+    replacer *pagereplacer,
     uint16_t virtualaddr,
     page *memory,
-    int *currmemorysize,
+    framepool *frames,
     swapspace *ss,
+    standby *sb,
+    subpage *sp,
+    framehash *fh,
     bool ismodified,
     uint8_t writevalue)
 {
-  // handle page fault using the fifo page replacement algorithm
-
   // extract the underlying page from swapspace
   uint16_t pageidx = SS_PAGEIDX(virtualaddr);
 #ifdef MEMSIM_ASSERTIONS
   assert(pageidx <= (uint16_t)1023);
 #endif
-  page *pagedin_page = get_pagecpy(ss, pageidx);
-  pagetableentry *pte_ref = NULL;
-  switch (algo)
-  {
-  case FIFO:
-  case CLOCK:
-  case ECLOCK:
-    basealgo *list = (basealgo *)pagereplacer;
-    pte_ref = get_pte_reference(list->type, list->vpt, virtualaddr);
-    break;
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    pte_ref = get_pte_reference(lrulist->type, lrulist->vpt, virtualaddr);
-    break;
-  }
-
-  struct pagereplacement result = run_pagereplacement(algo, pagereplacer, virtualaddr, pte_ref);
-#ifdef MEMSIM_ASSERTIONS
-  switch (algo)
+  // a page still on standby kept its contents in its free frame since its eviction,
+  // a page that never reached the swapspace is all zeros, neither needs a swap read
+  int standbyframe = sb != NULL ? standby_reclaim(sb, pageidx) : -1;
+  bool fromstandby = standbyframe != -1;
+  bool zerofilled = !fromstandby && !has_backingdata(ss, pageidx);
+  page *pagedin_page = NULL;
+  if (zerofilled)
   {
-  case FIFO:
-  case CLOCK:
-  case ECLOCK:
-    basealgo *list = (basealgo *)pagereplacer;
-    if ((*currmemorysize) < list->maxsize)
-    {
-      // there should be no eviction performed
-      assert(result.evictednode == NULL);
-    }
-    break;
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    if ((*currmemorysize) < lrulist->maxsize)
-    {
-      // there should be no eviction performed
-      assert(result.evictednode == NULL);
-    }
+    pagedin_page = (page *)calloc(1, sizeof(page));
   }
-#endif
-  if (result.evictednode == NULL)
+  else if (!fromstandby)
   {
-    // there will be no eviction if there is space in memory,
-    // increment currmemorysize
-    *currmemorysize = (*currmemorysize) + 1;
+    pagedin_page = get_pagecpy(ss, pageidx);
   }
-  else
+  PAGETABLE type = pagereplacer->type;
+  void *vpt = pagereplacer->vpt;
+  pagetableentry *pte_ref = get_pte_reference(type, vpt, virtualaddr);
+
+  replacer_onfault(pagereplacer, virtualaddr);
+  // there will be no eviction if there is a free frame in memory besides the ones kept for standby
+  struct reclaimresult reclaimed = reclaimframes(pagereplacer, memory, frames, ss, sb, sp, fh, 1 + (sb != NULL ? sb->reserve : 0));
+  uint16_t framenumber = fromstandby ? claim_frame(frames, (uint16_t)standbyframe) : acquire_frame(frames);
+  map_frame(frames, framenumber, pageidx);
+
+  if (!fromstandby)
   {
-    // there was a page eviction
-    // call the onunloadpage listener
-    page *evictedframe = memory + result.inmemoryoffset;
-    onunloadpage(
-        algo,
-        pagereplacer,
-        result.evictednode->msb_virtualaddr,
-        evictedframe,
-        ss);
-#ifdef MEMSIM_ASSERTIONS
-    assert(result.evictednode->next == NULL);
-#endif
-    free_algonode(result.evictednode);
+    memcpy(memory + framenumber, pagedin_page, sizeof(page));
   }
-
-#ifdef MEMSIM_ASSERTIONS
-  switch (algo)
+  if (fh != NULL)
   {
-  case FIFO:
-  case CLOCK:
-  case ECLOCK:
-    basealgo *list = (basealgo *)pagereplacer;
-    assert((*currmemorysize) <= list->maxsize);
-    break;
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    assert((*currmemorysize) <= lrulist->maxsize);
-    break;
+    framehash_onload(fh, framenumber, memory + framenumber);
   }
-
-#endif
-
-  // the page replacement result will hold the underlying in-memory offsets
-  memcpy(memory + result.inmemoryoffset, pagedin_page, sizeof(page));
   // update the frame number for the paged-in page entry
-  switch (algo)
-  {
-  case FIFO:
-  case CLOCK:
-  case ECLOCK:
-    basealgo *list = (basealgo *)pagereplacer;
-    update_framenumber(
-        list->type,
-        list->vpt,
-        virtualaddr,
-        result.inmemoryoffset);
-    // set the corresponding metabits in the pte
-    onloadpage(
-        list->vpt,
-        list->type,
-        virtualaddr,
-        ismodified);
-    break;
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    update_framenumber(
-        lrulist->type,
-        lrulist->vpt,
-        virtualaddr,
-        result.inmemoryoffset);
-    // set the corresponding metabits in the pte
-    onloadpage(
-        lrulist->vpt,
-        lrulist->type,
-        virtualaddr,
-        ismodified);
-    break;
-  }
+  update_framenumber(type, vpt, virtualaddr, framenumber);
+  // set the corresponding metabits in the pte
+  onloadpage(vpt, type, virtualaddr, ismodified);
+  replacer_onload(pagereplacer, virtualaddr, pte_ref);
 
   if (ismodified)
   {
-    writetopage(memory + result.inmemoryoffset, virtualaddr, writevalue);
+    writetopage(memory + framenumber, virtualaddr, writevalue);
   }
 
   free(pagedin_page);
   struct pagefaultresult updateresult = {
       .VA = virtualaddr,
-      .PFN = result.inmemoryoffset};
+      .PFN = framenumber,
+      .evictions = reclaimed.evictions,
+      .evictedVA = reclaimed.evictedVA,
+      .zerofilled = zerofilled,
+      .fromstandby = fromstandby};
   return updateresult;
 }
 
 /**
  * Algorithm-wise eviction selection
  */
-struct pagereplacement run_pagereplacement(ALGO algo, void *pagereplacer, uint16_t virtualaddr, pagetableentry *pte_ref)
+// node_victim: frees the node a list-based algorithm took out, returns the base virtual address it held, -1 if none
+static int node_victim(algonode *victim)
 {
-  switch (algo)
+  if (victim == NULL)
   {
-  case FIFO:
-    fifo *fifolist = (fifo *)pagereplacer;
-    return run_pagereplacement_fifo(fifolist, virtualaddr, pte_ref);
-  case CLOCK:
-    sclock *sclocklist = (sclock *)pagereplacer;
-    return run_pagereplacement_sclock(sclocklist, virtualaddr, pte_ref);
-  case ECLOCK:
-    eclock *eclocklist = (eclock *)pagereplacer;
-    return run_pagereplacement_eclock(eclocklist, virtualaddr, pte_ref);
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    return run_pagereplacement_lru(lrulist, virtualaddr, pte_ref);
+    return -1;
   }
+  int virtualaddr = victim->msb_virtualaddr;
+#ifdef MEMSIM_ASSERTIONS
+  assert(victim->next == NULL);
+#endif
+  free_algonode(victim);
+  return virtualaddr;
 }
 
-struct pagereplacement run_pagereplacement_fifo(fifo *fifolist, uint16_t virtualaddr, pagetableentry *pte_ref)
+// append_node: appends the node of a page just brought in to the list starting at head
+static void append_node(algonode **head, algonode *node)
 {
-  struct pagereplacement returnedstruct = {.evictednode = NULL, .inmemoryoffset = -1};
-  if (fifolist->head == NULL)
+  while (*head != NULL)
   {
-#ifdef MEMSIM_ASSERTIONS
-    assert(fifolist->currsize == 0);
-#endif
-    fifolist->head = (algonode *)malloc(sizeof(algonode));
-    init_algonode(&(fifolist->head), pte_ref, (virtualaddr & 0xffc0), fifolist->currsize, NULL);
-    returnedstruct.inmemoryoffset = fifolist->currsize;
+    head = &((*head)->next);
+  }
+  *head = node;
+}
+
+// unlink_node: takes node out of the list starting at head, prev being the node before it
+static algonode *unlink_node(algonode **head, algonode *prev, algonode *node)
+{
+  if (prev == NULL)
+  {
+    *head = node->next;
   }
   else
   {
-    algonode *tobe_pagedin = (algonode *)malloc(sizeof(algonode));
-    // perform an append first
-    algonode *curr = fifolist->head, *prev = NULL;
-    while (curr != NULL)
-    {
-      prev = curr;
-      curr = curr->next;
-    }
-    prev->next = tobe_pagedin;
-    // requires a page eviction if the memory is already full
-    // maintain reference to the underlying eviction entry
-    algonode *tobe_evicted = NULL;
-    bool evict = fifolist->currsize >= fifolist->maxsize;
-    if (evict)
-    {
-      tobe_evicted = fifolist->head;
-#ifdef MEMSIM_ASSERTIONS
-      assert(tobe_evicted != NULL);
-#endif
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          tobe_evicted->inmemoryoffset,
-          NULL);
-
-      // advance the list head
-      fifolist->head = fifolist->head->next;
-      // cut of the evicted node
-      tobe_evicted->next = NULL;
-      returnedstruct.inmemoryoffset = tobe_evicted->inmemoryoffset;
-      returnedstruct.evictednode = tobe_evicted;
-    }
-    else
-    {
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          fifolist->currsize,
-          NULL);
-      returnedstruct.inmemoryoffset = fifolist->currsize;
-      returnedstruct.evictednode = NULL;
-    }
+    prev->next = node->next;
   }
+  // cut of the evicted node
+  node->next = NULL;
+  return node;
+}
 
-  if (fifolist->currsize != fifolist->maxsize)
-    fifolist->currsize++;
+// OPT_KEY: next use of the page held by the heap node at slot
+#define OPT_KEY(optheap, slot) (optheap)->nextref[SS_PAGEIDX((optheap)->heap[slot]->msb_virtualaddr)]
 
-#ifdef MEMSIM_ASSERTIONS
-  assert(returnedstruct.inmemoryoffset != -1);
-  if (returnedstruct.evictednode == NULL)
-    assert(returnedstruct.inmemoryoffset < fifolist->maxsize);
-#endif
-  return returnedstruct;
+// opt_place: puts node at slot of the heap
+static void opt_place(opt *optheap, int slot, algonode *node)
+{
+  optheap->heap[slot] = node;
+  optheap->heapindex[SS_PAGEIDX(node->msb_virtualaddr)] = slot;
 }
 
-struct pagereplacement run_pagereplacement_sclock(sclock *sclocklist, uint16_t virtualaddr, pagetableentry *pte_ref)
+// opt_siftup: moves the node at slot up while its next use is farther than its parent's
+static void opt_siftup(opt *optheap, int slot)
 {
-  struct pagereplacement returnedstruct = {.evictednode = NULL, .inmemoryoffset = -1};
-  if (sclocklist->head == NULL)
+  algonode *node = optheap->heap[slot];
+  uint32_t key = optheap->nextref[SS_PAGEIDX(node->msb_virtualaddr)];
+  while (slot > 0 && OPT_KEY(optheap, (slot - 1) / 2) < key)
   {
-#ifdef MEMSIM_ASSERTIONS
-    assert(sclocklist->currsize == 0);
-#endif
-    sclocklist->head = (algonode *)malloc(sizeof(algonode));
-    init_algonode(&(sclocklist->head), pte_ref, (virtualaddr & 0xffc0), sclocklist->currsize, NULL);
-    returnedstruct.inmemoryoffset = sclocklist->currsize;
+    opt_place(optheap, slot, optheap->heap[(slot - 1) / 2]);
+    slot = (slot - 1) / 2;
   }
-  else
+  opt_place(optheap, slot, node);
+}
+
+// opt_siftdown: moves the node at slot down while a child is used later
+static void opt_siftdown(opt *optheap, int slot)
+{
+  algonode *node = optheap->heap[slot];
+  uint32_t key = optheap->nextref[SS_PAGEIDX(node->msb_virtualaddr)];
+  while (2 * slot + 1 < optheap->currsize)
   {
-    algonode *tobe_pagedin = (algonode *)malloc(sizeof(algonode));
-    // perform an append first
-    algonode *curr = sclocklist->head, *prev = NULL;
-    while (curr != NULL)
-    {
-      prev = curr;
-      curr = curr->next;
-    }
-    prev->next = tobe_pagedin;
-    // requires a page eviction if the memory is already full
-    // maintain reference to the underlying eviction entry
-    algonode *tobe_evicted = NULL;
-    bool evict = sclocklist->currsize >= sclocklist->maxsize;
-    if (evict)
+    int child = 2 * slot + 1;
+    if (child + 1 < optheap->currsize && OPT_KEY(optheap, child + 1) > OPT_KEY(optheap, child))
     {
-      algonode *innercurr, *innerprev;
-      innercurr = sclocklist->head;
-      innerprev = NULL;
-      while (isreferenced_pte(sclocklist->type, sclocklist->vpt, innercurr->msb_virtualaddr))
-      {
-        // give each a second chance
-        unset_referencedpte(sclocklist->type, sclocklist->vpt, innercurr->msb_virtualaddr);
-        innerprev = innercurr;
-        innercurr = innercurr->next;
-        if (innercurr == NULL)
-        {
-          // cycle to head
-          innercurr = sclocklist->head;
-          innerprev = NULL;
-        }
-      }
-      // remove the curr
-      if (innerprev == NULL)
-      {
-        sclocklist->head = innercurr->next;
-      }
-      else
-      {
-        innerprev->next = innercurr->next;
-      }
-
-      tobe_evicted = innercurr;
-
-#ifdef MEMSIM_ASSERTIONS
-      assert(tobe_evicted != NULL);
-#endif
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          tobe_evicted->inmemoryoffset,
-          NULL);
-
-      // cut of the evicted node
-      tobe_evicted->next = NULL;
-      returnedstruct.inmemoryoffset = tobe_evicted->inmemoryoffset;
-      returnedstruct.evictednode = tobe_evicted;
+      child++;
     }
-    else
+    if (OPT_KEY(optheap, child) <= key)
     {
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          sclocklist->currsize,
-          NULL);
-      returnedstruct.inmemoryoffset = sclocklist->currsize;
-      returnedstruct.evictednode = NULL;
+      break;
     }
+    opt_place(optheap, slot, optheap->heap[child]);
+    slot = child;
   }
+  opt_place(optheap, slot, node);
+}
+
+static void opt_push(opt *optheap, algonode *node)
+{
+  optheap->currsize++;
+  opt_place(optheap, optheap->currsize - 1, node);
+  opt_siftup(optheap, optheap->currsize - 1);
+}
 
-  if (sclocklist->currsize != sclocklist->maxsize)
-    sclocklist->currsize++;
+// arc_unlink: takes vpn off the list it is on
+static void arc_unlink(arc *arclist, int vpn)
+{
+  arclist->next[arclist->prev[vpn]] = arclist->next[vpn];
+  arclist->prev[arclist->next[vpn]] = arclist->prev[vpn];
+  arclist->size[arclist->where[vpn]]--;
+  arclist->where[vpn] = ARC_NONE;
+}
 
-#ifdef MEMSIM_ASSERTIONS
-  assert(returnedstruct.inmemoryoffset != -1);
-  if (returnedstruct.evictednode == NULL)
-    assert(returnedstruct.inmemoryoffset < sclocklist->maxsize);
-#endif
-  return returnedstruct;
+// arc_pushmru: puts vpn at the MRU end of list
+static void arc_pushmru(arc *arclist, int vpn, int list)
+{
+  int sentinel = PAGES + list;
+  arclist->prev[vpn] = sentinel;
+  arclist->next[vpn] = arclist->next[sentinel];
+  arclist->prev[arclist->next[sentinel]] = vpn;
+  arclist->next[sentinel] = vpn;
+  arclist->size[list]++;
+  arclist->where[vpn] = list;
 }
 
-struct pagereplacement run_pagereplacement_eclock(eclock *eclocklist, uint16_t virtualaddr, pagetableentry *pte_ref)
+// arc_lru: the LRU page of list, which must not be empty
+static int arc_lru(const arc *arclist, int list)
 {
-  struct pagereplacement returnedstruct = {.evictednode = NULL, .inmemoryoffset = -1};
-  if (eclocklist->head == NULL)
+  return arclist->prev[PAGES + list];
+}
+
+// arc_insert: a page faulted in goes to T1, or to T2 if it was remembered by a ghost list
+// the ghost lists are then trimmed so that T1 and B1 hold at most c pages and all lists 2c
+static void arc_insert(arc *arclist, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  int c = arclist->maxsize;
+  arc_pushmru(arclist, vpn, vpn == arclist->pending ? ARC_T2 : ARC_T1);
+  arclist->pending = -1;
+  arclist->pendingb2 = false;
+  arclist->currsize++;
+  while (arclist->size[ARC_T1] + arclist->size[ARC_B1] > c && arclist->size[ARC_B1] > 0)
   {
-#ifdef MEMSIM_ASSERTIONS
-    assert(eclocklist->currsize == 0);
-#endif
-    eclocklist->head = (algonode *)malloc(sizeof(algonode));
-    init_algonode(&(eclocklist->head), pte_ref, (virtualaddr & 0xffc0), eclocklist->currsize, NULL);
-    returnedstruct.inmemoryoffset = eclocklist->currsize;
+    arc_unlink(arclist, arc_lru(arclist, ARC_B1));
   }
-  else
+  while (arclist->currsize + arclist->size[ARC_B1] + arclist->size[ARC_B2] > 2 * c && arclist->size[ARC_B2] > 0)
   {
-    algonode *tobe_pagedin = (algonode *)malloc(sizeof(algonode));
-    // perform an append first
-    algonode *curr = eclocklist->head, *prev = NULL;
-    while (curr != NULL)
-    {
-      prev = curr;
-      curr = curr->next;
-    }
-    prev->next = tobe_pagedin;
-    // requires a page eviction if the memory is already full
-    // maintain reference to the underlying eviction entry
-    algonode *tobe_evicted = NULL;
-    bool evict = eclocklist->currsize >= eclocklist->maxsize;
-    if (evict)
-    {
-      algonode *innercurr, *innerprev;
-      int step = 1;
-      bool found = false;
-    cycle:
-      innercurr = eclocklist->head;
-      innerprev = NULL;
-      while (innercurr != NULL)
-      {
-        bool isreferenced = isreferenced_pte(eclocklist->type, eclocklist->vpt, innercurr->msb_virtualaddr);
-        bool ismodified = ismodified_pte(eclocklist->type, eclocklist->vpt, innercurr->msb_virtualaddr);
-        if (step == 1 || step == 3)
-        {
-          if (!isreferenced && !ismodified)
-          {
-            found = true;
-            break;
-          }
-        }
-        else if (step == 2 || step == 4)
-        {
-          if (!isreferenced && ismodified)
-          {
-            found = true;
-            break;
-          }
-          if (step == 2)
-          {
-            unset_referencedpte(eclocklist->type, eclocklist->head, innercurr->msb_virtualaddr);
-          }
-        }
-        innerprev = innercurr;
-        innercurr = innercurr->next;
-      }
-      step++;
-      if (step != 5 && !found)
-      {
-        goto cycle;
-      }
+    arc_unlink(arclist, arc_lru(arclist, ARC_B2));
+  }
+}
 
-      // remove the curr
-      if (innerprev == NULL)
-      {
-        eclocklist->head = innercurr->next;
-      }
-      else
-      {
-        innerprev->next = innercurr->next;
-      }
+// clockpro_link: puts vpn on the clock right behind the hot hand, the last place the hands get to
+static void clockpro_link(clockpro *clock, int vpn)
+{
+  if (clock->handhot == -1)
+  {
+    clock->prev[vpn] = vpn;
+    clock->next[vpn] = vpn;
+    clock->handhot = clock->handcold = clock->handtest = vpn;
+    return;
+  }
+  int behind = clock->prev[clock->handhot];
+  clock->prev[vpn] = behind;
+  clock->next[vpn] = clock->handhot;
+  clock->next[behind] = vpn;
+  clock->prev[clock->handhot] = vpn;
+}
 
-      tobe_evicted = innercurr;
+// clockpro_unlink: takes vpn off the clock, hands on it move on to the next page
+static void clockpro_unlink(clockpro *clock, int vpn)
+{
+  int next = clock->next[vpn] == vpn ? -1 : clock->next[vpn];
+  if (clock->handhot == vpn)
+    clock->handhot = next;
+  if (clock->handcold == vpn)
+    clock->handcold = next;
+  if (clock->handtest == vpn)
+    clock->handtest = next;
+  clock->next[clock->prev[vpn]] = clock->next[vpn];
+  clock->prev[clock->next[vpn]] = clock->prev[vpn];
+}
 
-#ifdef MEMSIM_ASSERTIONS
-      assert(tobe_evicted != NULL);
-#endif
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          tobe_evicted->inmemoryoffset,
-          NULL);
-
-      // cut of the evicted node
-      tobe_evicted->next = NULL;
-      returnedstruct.inmemoryoffset = tobe_evicted->inmemoryoffset;
-      returnedstruct.evictednode = tobe_evicted;
-    }
-    else
-    {
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          eclocklist->currsize,
-          NULL);
-      returnedstruct.inmemoryoffset = eclocklist->currsize;
-      returnedstruct.evictednode = NULL;
-    }
+// clockpro_movetohead: moves vpn behind the hot hand, the hand passing it moves on first
+static void clockpro_movetohead(clockpro *clock, int vpn)
+{
+  if (clock->next[vpn] == vpn)
+  {
+    return;
   }
+  clockpro_unlink(clock, vpn);
+  clockpro_link(clock, vpn);
+}
 
-  if (eclocklist->currsize != eclocklist->maxsize)
-    eclocklist->currsize++;
-
-#ifdef MEMSIM_ASSERTIONS
-  assert(returnedstruct.inmemoryoffset != -1);
-  if (returnedstruct.evictednode == NULL)
-    assert(returnedstruct.inmemoryoffset < eclocklist->maxsize);
-#endif
-  return returnedstruct;
+static void clockpro_adapt(clockpro *clock, int delta)
+{
+  clockprostats *stats = &(clock->stats);
+  clock->coldtarget += delta;
+  if (clock->coldtarget < 1)
+    clock->coldtarget = 1;
+  if (clock->coldtarget > clock->maxsize - 1)
+    clock->coldtarget = clock->maxsize - 1;
+  if (clock->coldtarget < stats->coldmin)
+    stats->coldmin = clock->coldtarget;
+  if (clock->coldtarget > stats->coldmax)
+    stats->coldmax = clock->coldtarget;
 }
 
-struct pagereplacement run_pagereplacement_lru(lru *lrulist, uint16_t virtualaddr, pagetableentry *pte_ref)
+// clockpro_endtest: ends the test period of vpn without a re-reference, memory for cold pages was enough
+// a non-resident page leaves the clock, returns true if it did
+static bool clockpro_endtest(clockpro *clock, int vpn)
 {
-  struct pagereplacement returnedstruct = {.evictednode = NULL, .inmemoryoffset = -1};
-  if (lrulist->head == NULL)
+  clock->test[vpn] = false;
+  clock->stats.testexpiries++;
+  clockpro_adapt(clock, -1);
+  if (clock->state[vpn] != CLOCKPRO_NONRESIDENT)
   {
-#ifdef MEMSIM_ASSERTIONS
-    assert(lrulist->currsize == 0);
-#endif
-    lrulist->head = (algonode *)malloc(sizeof(algonode));
-    init_algonode(&(lrulist->head), pte_ref, (virtualaddr & 0xffc0), lrulist->currsize, NULL);
-    lrulist->head->lastreferenced = (double)(clock() - lrulist->start);
-    returnedstruct.inmemoryoffset = lrulist->currsize;
+    return false;
   }
-  else
+  clockpro_unlink(clock, vpn);
+  clock->state[vpn] = CLOCKPRO_NONE;
+  clock->nonresident--;
+  return true;
+}
+
+// clockpro_runhot: moves the hot hand until it demoted a hot page
+// must only run while there is a hot page
+static void clockpro_runhot(clockpro *clock)
+{
+  while (true)
   {
-    algonode *tobe_pagedin = (algonode *)malloc(sizeof(algonode));
-    tobe_pagedin->lastreferenced = (double)(clock() - lrulist->start);
-    // perform an append first
-    algonode *curr = lrulist->head, *prev = NULL;
-    while (curr != NULL)
-    {
-      prev = curr;
-      curr = curr->next;
-    }
-    prev->next = tobe_pagedin;
-    // requires a page eviction if the memory is already full
-    // maintain reference to the underlying eviction entry
-    algonode *tobe_evicted = NULL;
-    bool evict = lrulist->currsize >= lrulist->maxsize;
-    if (evict)
+    int vpn = clock->handhot;
+    uint16_t virtualaddr = vpn << 6;
+    if (clock->state[vpn] == CLOCKPRO_HOT)
     {
-      algonode *innercurr, *innerprev;
-      innercurr = lrulist->head;
-      innerprev = NULL;
-      algonode *leastrecentlyused = innercurr;
-      while (innercurr != NULL)
-      {
-        if (leastrecentlyused->lastreferenced > innercurr->lastreferenced)
-        {
-          leastrecentlyused = innercurr;
-        }
-        innerprev = innercurr;
-        innercurr = innercurr->next;
-      }
-
-      if (leastrecentlyused == lrulist->head)
-      {
-        lrulist->head = lrulist->head->next;
-      }
-      else
+      clock->handhot = clock->next[vpn];
+      if (isreferenced_pte(clock->type, clock->vpt, virtualaddr))
       {
-        innerprev->next = leastrecentlyused->next;
+        unset_referencedpte(clock->type, clock->vpt, virtualaddr);
+        continue;
       }
-
-      tobe_evicted = leastrecentlyused;
-
-#ifdef MEMSIM_ASSERTIONS
-      assert(tobe_evicted != NULL);
-#endif
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          tobe_evicted->inmemoryoffset,
-          NULL);
-
-      // cut of the evicted node
-      tobe_evicted->next = NULL;
-      returnedstruct.inmemoryoffset = tobe_evicted->inmemoryoffset;
-      returnedstruct.evictednode = tobe_evicted;
+      clock->state[vpn] = CLOCKPRO_COLD;
+      clock->hot--;
+      clock->cold++;
+      clock->stats.demotions++;
+      return;
     }
-    else
+    if (!clock->test[vpn] || !clockpro_endtest(clock, vpn))
     {
-      init_algonode(
-          &tobe_pagedin,
-          pte_ref,
-          (virtualaddr & 0xffc0),
-          lrulist->currsize,
-          NULL);
-      returnedstruct.inmemoryoffset = lrulist->currsize;
-      returnedstruct.evictednode = NULL;
+      clock->handhot = clock->next[vpn];
     }
   }
-
-  if (lrulist->currsize != lrulist->maxsize)
-    lrulist->currsize++;
-
-#ifdef MEMSIM_ASSERTIONS
-  assert(returnedstruct.inmemoryoffset != -1);
-  if (returnedstruct.evictednode == NULL)
-    assert(returnedstruct.inmemoryoffset < lrulist->maxsize);
-#endif
-  return returnedstruct;
 }
 
-void onloadpage(
-    void *vpt,
-    PAGETABLE type,
-    uint16_t virtualaddr,
-    bool ismodified)
+// clockpro_runtest: moves the test hand until no more than maxsize non-resident pages are left
+static void clockpro_runtest(clockpro *clock)
 {
-  // this utility function sets the metabits
-  // for the loaded page
-  // it sets the valid bit to one
-  // it sets the referenced bit to one
-  // if the page was for write, sets the modified bit to one
-  set_validpte(type, vpt, virtualaddr);
-  set_referencedpte(type, vpt, virtualaddr);
-  if (ismodified)
+  while (clock->nonresident > clock->maxsize)
   {
-    set_modifiedpte(type, vpt, virtualaddr);
+    int vpn = clock->handtest;
+    if (!clock->test[vpn] || !clockpro_endtest(clock, vpn))
+    {
+      clock->handtest = clock->next[vpn];
+    }
   }
 }
 
-void writetopage(
-    page *frame,
-    uint16_t virtualaddr,
-    uint8_t value)
+// clockpro_insert: a page faulted in during its test period turns hot, any other one starts out cold on test
+static void clockpro_insert(clockpro *clock, uint16_t virtualaddr)
 {
-  uint16_t offset = virtualaddr & 0x003f;
-  frame->content[offset] = value;
-}
-
-void onunloadpage(
-    ALGO algo,
-    void *pagereplacer,
-    uint16_t virtualaddr,
-    page *frame,
-    swapspace *ss)
-{
-  PAGETABLE type;
-  void *vpt;
-  switch (algo)
-  {
-  case FIFO:
-  case CLOCK:
-  case ECLOCK:
-    basealgo *list = (basealgo *)pagereplacer;
-    type = list->type;
-    vpt = list->vpt;
-    break;
-  case LRU:
-    lru *lrulist = (lru *)pagereplacer;
-    type = lrulist->type;
-    vpt = lrulist->vpt;
+  int vpn = SS_PAGEIDX(virtualaddr);
+  if (clock->state[vpn] == CLOCKPRO_NONRESIDENT)
+  {
+    // its reuse distance was short, a larger cold share would have kept it
+    clock->nonresident--;
+    clock->test[vpn] = false;
+    clock->state[vpn] = CLOCKPRO_HOT;
+    clock->hot++;
+    clock->stats.testhits++;
+    clockpro_adapt(clock, 1);
+    clockpro_movetohead(clock, vpn);
   }
-
-  uint16_t pageidx = SS_PAGEIDX(virtualaddr);
-
-  if (ismodified_pte(type, vpt, virtualaddr))
+  else
   {
-    write_page(ss, pageidx, frame);
+    clock->state[vpn] = CLOCKPRO_COLD;
+    clock->test[vpn] = true;
+    clock->cold++;
+    clockpro_link(clock, vpn);
   }
+  clock->currsize++;
+  if (clock->hot > clock->maxsize - clock->coldtarget)
+  {
+    clockpro_runhot(clock);
+  }
+}
 
-  // clear all the metabits
-  unset_validpte(type, vpt, virtualaddr);
-  unset_referencedpte(type, vpt, virtualaddr);
-  unset_modifiedpte(type, vpt, virtualaddr);
+// MGLRU_SENTINEL: list slot of generation seq
+#define MGLRU_SENTINEL(gens, seq) (PAGES + (int)((seq) % (gens)->generations))
+
+// mglru_unlink: takes vpn out of its generation
+static void mglru_unlink(mglru *gens, int vpn)
+{
+  gens->next[gens->prev[vpn]] = gens->next[vpn];
+  gens->prev[gens->next[vpn]] = gens->prev[vpn];
+  gens->size[MGLRU_SENTINEL(gens, gens->seq[vpn]) - PAGES]--;
+  gens->seq[vpn] = -1;
 }
 
-/**
- * Algorithm Specific Constructors and Destructors
- */
-fifo *new_fifo(
-    PAGETABLE type,
-    void *vpt,
-    int fcount)
+// mglru_push: adds vpn to generation seq as its most recently added page
+static void mglru_push(mglru *gens, int vpn, unsigned long seq)
 {
-  fifo *newfifo = (fifo *)malloc(sizeof(fifo));
-  newfifo->head = NULL;
-  newfifo->currsize = 0;
-  newfifo->maxsize = fcount;
-  newfifo->type = type;
-  newfifo->vpt = vpt;
-  return newfifo;
+  int sentinel = MGLRU_SENTINEL(gens, seq);
+  gens->prev[vpn] = sentinel;
+  gens->next[vpn] = gens->next[sentinel];
+  gens->prev[gens->next[sentinel]] = vpn;
+  gens->next[sentinel] = vpn;
+  gens->size[sentinel - PAGES]++;
+  gens->seq[vpn] = (long)seq;
 }
 
-void free_fifo(fifo *fifolist)
+// mglru_fold: merges the oldest generation into the next one, its pages become the oldest of that one
+static void mglru_fold(mglru *gens)
 {
-  if (fifolist)
+  int from = MGLRU_SENTINEL(gens, gens->minseq);
+  int into = MGLRU_SENTINEL(gens, gens->minseq + 1);
+  for (int vpn = gens->next[from]; vpn != from; vpn = gens->next[vpn])
   {
-    free_algonode(fifolist->head);
-    free(fifolist);
+    gens->seq[vpn] = (long)gens->minseq + 1;
+  }
+  if (gens->size[from - PAGES] > 0)
+  {
+    // splice the whole list in behind the oldest page of the next generation
+    int first = gens->next[from];
+    int last = gens->prev[from];
+    int oldest = gens->prev[into];
+    gens->next[oldest] = first;
+    gens->prev[first] = oldest;
+    gens->next[last] = into;
+    gens->prev[into] = last;
+    gens->size[into - PAGES] += gens->size[from - PAGES];
   }
+  gens->next[from] = gens->prev[from] = from;
+  gens->size[from - PAGES] = 0;
+  gens->minseq++;
+  gens->stats.folds++;
 }
 
-sclock *new_sclock(
-    PAGETABLE type,
-    void *vpt,
-    int fcount)
+// aging_before: true if the page in slot a goes before the one in slot b
+static bool aging_before(const aging *counters, int a, int b)
 {
-  sclock *newsclock = (sclock *)malloc(sizeof(sclock));
-  newsclock->head = NULL;
-  newsclock->currsize = 0;
-  newsclock->maxsize = fcount;
-  newsclock->type = type;
-  newsclock->vpt = vpt;
-  return newsclock;
+  if (counters->age[a] != counters->age[b])
+  {
+    return counters->age[a] < counters->age[b];
+  }
+  return (int32_t)(counters->loaded[a] - counters->loaded[b]) < 0;
 }
 
-void free_sclock(sclock *sclocklist)
+static void aging_place(aging *counters, int position, int slot)
 {
-  if (sclocklist)
+  counters->heap[position] = slot;
+  counters->heapindex[slot] = position;
+}
+
+static void aging_siftup(aging *counters, int position)
+{
+  int slot = counters->heap[position];
+  while (position > 0 && aging_before(counters, slot, counters->heap[(position - 1) / 2]))
   {
-    free_algonode(sclocklist->head);
-    free(sclocklist);
+    aging_place(counters, position, counters->heap[(position - 1) / 2]);
+    position = (position - 1) / 2;
   }
+  aging_place(counters, position, slot);
 }
 
-eclock *new_eclock(
-    PAGETABLE type,
-    void *vpt,
-    int fcount)
+static void aging_siftdown(aging *counters, int position)
 {
-  eclock *neweclock = (eclock *)malloc(sizeof(eclock));
-  neweclock->head = NULL;
-  neweclock->currsize = 0;
-  neweclock->maxsize = fcount;
-  neweclock->type = type;
-  neweclock->vpt = vpt;
-  return neweclock;
+  int slot = counters->heap[position];
+  while (2 * position + 1 < counters->currsize)
+  {
+    int child = 2 * position + 1;
+    if (child + 1 < counters->currsize && aging_before(counters, counters->heap[child + 1], counters->heap[child]))
+    {
+      child++;
+    }
+    if (!aging_before(counters, counters->heap[child], slot))
+    {
+      break;
+    }
+    aging_place(counters, position, counters->heap[child]);
+    position = child;
+  }
+  aging_place(counters, position, slot);
 }
 
-void free_eclock(eclock *eclocklist)
+// aging_insert: a page brought in counts as referenced in the last tick, it is not the next victim
+static void aging_insert(aging *counters, uint16_t virtualaddr)
 {
-  if (eclocklist)
+  int slot = counters->currsize;
+  uint16_t vpn = SS_PAGEIDX(virtualaddr);
+  counters->age[slot] = (uint32_t)1 << (counters->bits - 1);
+  counters->loaded[slot] = counters->stamp++;
+  counters->vpnof[slot] = vpn;
+  counters->slotof[vpn] = slot;
+  counters->currsize++;
+  aging_place(counters, slot, slot);
+  aging_siftup(counters, slot);
+}
+
+// wsclock_insert: puts the page right behind the hand, the last place it gets to
+static void wsclock_insert(wsclock *ws, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  if (ws->hand == -1)
   {
-    free_algonode(eclocklist->head);
-    free(eclocklist);
+    ws->prev[vpn] = vpn;
+    ws->next[vpn] = vpn;
+    ws->hand = vpn;
+  }
+  else
+  {
+    int behind = ws->prev[ws->hand];
+    ws->prev[vpn] = behind;
+    ws->next[vpn] = ws->hand;
+    ws->next[behind] = vpn;
+    ws->prev[ws->hand] = vpn;
   }
+  ws->currsize++;
 }
 
-lru *new_lru(
-    PAGETABLE type,
-    void *vpt,
-    int fcount)
+// lfu_newbucket: takes a bucket out of the pool for count and links it right above bucket below, at the bottom if below is -1
+static int lfu_newbucket(lfu *freqs, uint32_t count, int below)
 {
-  lru *newlru = (lru *)malloc(sizeof(lru));
-  newlru->start = clock();
-  newlru->head = NULL;
-  newlru->currsize = 0;
-  newlru->maxsize = fcount;
-  newlru->type = type;
-  newlru->vpt = vpt;
-  return newlru;
+  int bucket = freqs->freebuckets;
+  freqs->freebuckets = freqs->higher[bucket];
+  freqs->count[bucket] = count;
+  freqs->first[bucket] = -1;
+  freqs->last[bucket] = -1;
+  freqs->lower[bucket] = below;
+  freqs->higher[bucket] = below == -1 ? freqs->lowest : freqs->higher[below];
+  if (freqs->higher[bucket] != -1)
+    freqs->lower[freqs->higher[bucket]] = bucket;
+  if (below == -1)
+    freqs->lowest = bucket;
+  else
+    freqs->higher[below] = bucket;
+  freqs->nbuckets++;
+  if (freqs->nbuckets > freqs->stats.maxbuckets)
+    freqs->stats.maxbuckets = freqs->nbuckets;
+  return bucket;
 }
 
-void free_lru(lru *lrulist)
+// lfu_freebucket: unlinks an empty bucket and gives it back to the pool
+static void lfu_freebucket(lfu *freqs, int bucket)
 {
-  if (lrulist)
+  if (freqs->lower[bucket] != -1)
+    freqs->higher[freqs->lower[bucket]] = freqs->higher[bucket];
+  else
+    freqs->lowest = freqs->higher[bucket];
+  if (freqs->higher[bucket] != -1)
+    freqs->lower[freqs->higher[bucket]] = freqs->lower[bucket];
+  freqs->higher[bucket] = freqs->freebuckets;
+  freqs->freebuckets = bucket;
+  freqs->nbuckets--;
+}
+
+// lfu_append: makes vpn the newest page of bucket
+static void lfu_append(lfu *freqs, int bucket, int vpn)
+{
+  freqs->bucketof[vpn] = bucket;
+  freqs->prev[vpn] = freqs->last[bucket];
+  freqs->next[vpn] = -1;
+  if (freqs->last[bucket] != -1)
+    freqs->next[freqs->last[bucket]] = vpn;
+  else
+    freqs->first[bucket] = vpn;
+  freqs->last[bucket] = vpn;
+}
+
+// lfu_detach: takes vpn out of its bucket, the bucket goes back to the pool once it is empty
+static void lfu_detach(lfu *freqs, int vpn)
+{
+  int bucket = freqs->bucketof[vpn];
+  if (freqs->prev[vpn] != -1)
+    freqs->next[freqs->prev[vpn]] = freqs->next[vpn];
+  else
+    freqs->first[bucket] = freqs->next[vpn];
+  if (freqs->next[vpn] != -1)
+    freqs->prev[freqs->next[vpn]] = freqs->prev[vpn];
+  else
+    freqs->last[bucket] = freqs->prev[vpn];
+  freqs->bucketof[vpn] = -1;
+  if (freqs->first[bucket] == -1)
+    lfu_freebucket(freqs, bucket);
+}
+
+// lfu_insert: a page brought in has been referenced once
+// after a decay the lowest bucket may hold count 0, the bucket for count 1 is then the next one
+static void lfu_insert(lfu *freqs, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  int below = -1;
+  int bucket = freqs->lowest;
+  if (bucket != -1 && freqs->count[bucket] == 0)
   {
-    free_algonode(lrulist->head);
-    free(lrulist);
+    below = bucket;
+    bucket = freqs->higher[bucket];
+  }
+  if (bucket == -1 || freqs->count[bucket] != 1)
+  {
+    bucket = lfu_newbucket(freqs, 1, below);
   }
+  lfu_append(freqs, bucket, vpn);
+  freqs->currsize++;
 }
 
-void update_referencedtime(lru *list, uint16_t virtualaddr)
+// recency_init: empties the list
+static void recency_init(recencylist *list)
 {
-  algonode *curr = list->head;
-  uint16_t msb_virtualaddr = (virtualaddr & 0xffc0);
-  while (curr != NULL)
+  list->head = -1;
+  list->tail = -1;
+  list->size = 0;
+  memset(list->member, 0, sizeof(list->member));
+}
+
+// recency_remove: takes vpn off the list
+static void recency_remove(recencylist *list, int vpn)
+{
+  if (list->prev[vpn] != -1)
+    list->next[list->prev[vpn]] = list->next[vpn];
+  else
+    list->head = list->next[vpn];
+  if (list->next[vpn] != -1)
+    list->prev[list->next[vpn]] = list->prev[vpn];
+  else
+    list->tail = list->prev[vpn];
+  list->member[vpn] = false;
+  list->size--;
+}
+
+// recency_touch: makes vpn the most recently used page, adding it if it is not on the list
+static void recency_touch(recencylist *list, int vpn)
+{
+  if (list->member[vpn])
   {
-    if (curr->msb_virtualaddr == msb_virtualaddr)
-    {
-      curr->lastreferenced = (double)(clock() - list->start);
+    if (list->head == vpn)
       return;
+    recency_remove(list, vpn);
+  }
+  list->prev[vpn] = -1;
+  list->next[vpn] = list->head;
+  if (list->head != -1)
+    list->prev[list->head] = vpn;
+  else
+    list->tail = vpn;
+  list->head = vpn;
+  list->member[vpn] = true;
+  list->size++;
+}
+
+// adaptive_insert: a page brought in joins both orders as used once, right now
+static void adaptive_insert(adaptive *duel, uint16_t virtualaddr)
+{
+  recency_touch(&(duel->recency), SS_PAGEIDX(virtualaddr));
+  lfu_insert(duel->frequency, virtualaddr);
+  duel->currsize++;
+}
+
+// adaptive_endepoch: halves the shadow scores and hands eviction to the best shadow if it beats the live one by the margin
+static void adaptive_endepoch(adaptive *duel)
+{
+  ADAPTIVEPOLICY best = duel->live;
+  for (int policy = 0; policy < ADAPTIVE_POLICIES; policy++)
+  {
+    duel->score[policy] = duel->score[policy] / 2 + duel->epochmisses[policy];
+    duel->epochmisses[policy] = 0;
+    if (duel->score[policy] < duel->score[best])
+      best = (ADAPTIVEPOLICY)policy;
+  }
+  duel->epochreferences = 0;
+  duel->stats.epochs++;
+  if (best == duel->live || duel->score[best] * 100 >= duel->score[duel->live] * (100 - ADAPTIVE_MARGIN))
+  {
+    return;
+  }
+  if (duel->stats.switches < ADAPTIVE_LOG)
+  {
+    adaptiveswitch *entry = duel->stats.log + duel->stats.switches;
+    entry->reference = duel->now;
+    entry->from = duel->live;
+    entry->to = best;
+  }
+  duel->stats.switches++;
+  duel->live = best;
+}
+
+algonode *run_eviction_fifo(fifo *fifolist)
+{
+  if (fifolist->head == NULL)
+  {
+    return NULL;
+  }
+  fifolist->currsize--;
+  return unlink_node(&(fifolist->head), NULL, fifolist->head);
+}
+
+algonode *run_eviction_sclock(sclock *sclocklist)
+{
+  if (sclocklist->head == NULL)
+  {
+    return NULL;
+  }
+  algonode *innercurr, *innerprev;
+  innercurr = sclocklist->head;
+  innerprev = NULL;
+  while (isreferenced_pte(sclocklist->type, sclocklist->vpt, innercurr->msb_virtualaddr))
+  {
+    // give each a second chance
+    unset_referencedpte(sclocklist->type, sclocklist->vpt, innercurr->msb_virtualaddr);
+    innerprev = innercurr;
+    innercurr = innercurr->next;
+    if (innercurr == NULL)
+    {
+      // cycle to head
+      innercurr = sclocklist->head;
+      innerprev = NULL;
     }
-    curr = curr->next;
   }
+  sclocklist->currsize--;
+  return unlink_node(&(sclocklist->head), innerprev, innercurr);
 }
 
-void init_algonode(
-    algonode **node,
-    pagetableentry *pte,
-    uint16_t msb_va,
-    uint16_t mem_offset,
-    algonode *next)
+algonode *run_eviction_eclock(eclock *eclocklist)
 {
+  if (eclocklist->head == NULL)
+  {
+    return NULL;
+  }
+  algonode *innercurr, *innerprev;
+  int step = 1;
+  bool found = false;
+cycle:
+  innercurr = eclocklist->head;
+  innerprev = NULL;
+  while (innercurr != NULL)
+  {
+    bool isreferenced = isreferenced_pte(eclocklist->type, eclocklist->vpt, innercurr->msb_virtualaddr);
+    bool ismodified = ismodified_pte(eclocklist->type, eclocklist->vpt, innercurr->msb_virtualaddr);
+    if (step == 1 || step == 3)
+    {
+      if (!isreferenced && !ismodified)
+      {
+        found = true;
+        break;
+      }
+    }
+    else if (step == 2 || step == 4)
+    {
+      if (!isreferenced && ismodified)
+      {
+        found = true;
+        break;
+      }
+      if (step == 2)
+      {
+        unset_referencedpte(eclocklist->type, eclocklist->vpt, innercurr->msb_virtualaddr);
+      }
+    }
+    innerprev = innercurr;
+    innercurr = innercurr->next;
+  }
+  step++;
+  if (step != 5 && !found)
+  {
+    goto cycle;
+  }
+
 #ifdef MEMSIM_ASSERTIONS
-  assert(node != NULL);
+  assert(innercurr != NULL);
 #endif
-  (*node)->pte_ref = pte;
-  (*node)->msb_virtualaddr = msb_va;
-  (*node)->inmemoryoffset = mem_offset;
-  (*node)->next = next;
+  eclocklist->currsize--;
+  return unlink_node(&(eclocklist->head), innerprev, innercurr);
 }
 
-void free_algonode(algonode *node)
+algonode *run_eviction_lru(lru *lrulist)
 {
-  if (node)
+  if (lrulist->head == NULL)
   {
-    if (node->next)
+    return NULL;
+  }
+  algonode *innercurr, *innerprev;
+  innercurr = lrulist->head;
+  innerprev = NULL;
+  algonode *leastrecentlyused = innercurr;
+  algonode *leastrecentlyusedprev = NULL;
+  while (innercurr != NULL)
+  {
+    if (leastrecentlyused->lastreferenced > innercurr->lastreferenced)
     {
-      free_algonode(node);
+      leastrecentlyused = innercurr;
+      leastrecentlyusedprev = innerprev;
     }
-    free(node);
+    innerprev = innercurr;
+    innercurr = innercurr->next;
+  }
+  lrulist->currsize--;
+  return unlink_node(&(lrulist->head), leastrecentlyusedprev, leastrecentlyused);
+}
+
+algonode *run_eviction_opt(opt *optheap)
+{
+  if (optheap->currsize == 0)
+  {
+    return NULL;
+  }
+  // the root is the page used farthest in the future, or never again
+  algonode *victim = optheap->heap[0];
+  optheap->heapindex[SS_PAGEIDX(victim->msb_virtualaddr)] = -1;
+  optheap->currsize--;
+  if (optheap->currsize > 0)
+  {
+    opt_place(optheap, 0, optheap->heap[optheap->currsize]);
+    opt_siftdown(optheap, 0);
+  }
+  return victim;
+}
+
+// run_eviction_arc: ARC's REPLACE, evicts from T1 while it is above its target and from T2 otherwise,
+// the victim is remembered on the matching ghost list
+int run_eviction_arc(arc *arclist)
+{
+  if (arclist->currsize == 0)
+  {
+    return -1;
+  }
+  int t1 = arclist->size[ARC_T1];
+  bool fromt1 = t1 > 0 && (t1 > arclist->p || (arclist->pendingb2 && t1 == arclist->p) || arclist->size[ARC_T2] == 0);
+  int vpn = arc_lru(arclist, fromt1 ? ARC_T1 : ARC_T2);
+  arc_unlink(arclist, vpn);
+  arc_pushmru(arclist, vpn, fromt1 ? ARC_B1 : ARC_B2);
+  arclist->currsize--;
+  return vpn << 6;
+}
+
+// run_eviction_clockpro: moves the cold hand until it finds a resident cold page that was not referenced
+// a referenced one turns hot if it was on test and starts a new test period otherwise
+int run_eviction_clockpro(clockpro *clock)
+{
+  if (clock->currsize == 0)
+  {
+    return -1;
+  }
+  while (true)
+  {
+    if (clock->cold == 0)
+    {
+      // every resident page is hot
+      clockpro_runhot(clock);
+    }
+    int vpn = clock->handcold;
+    uint16_t virtualaddr = vpn << 6;
+    clock->handcold = clock->next[vpn];
+    if (clock->state[vpn] != CLOCKPRO_COLD)
+    {
+      continue;
+    }
+    if (isreferenced_pte(clock->type, clock->vpt, virtualaddr))
+    {
+      unset_referencedpte(clock->type, clock->vpt, virtualaddr);
+      if (clock->test[vpn])
+      {
+        clock->test[vpn] = false;
+        clock->state[vpn] = CLOCKPRO_HOT;
+        clock->cold--;
+        clock->hot++;
+        clock->stats.promotions++;
+      }
+      else
+      {
+        clock->test[vpn] = true;
+      }
+      clockpro_movetohead(clock, vpn);
+      if (clock->hot > clock->maxsize - clock->coldtarget)
+      {
+        clockpro_runhot(clock);
+      }
+      continue;
+    }
+    clock->cold--;
+    clock->currsize--;
+    if (clock->test[vpn])
+    {
+      // the entry stays until its test ends
+      clock->state[vpn] = CLOCKPRO_NONRESIDENT;
+      clock->nonresident++;
+      clockpro_runtest(clock);
+    }
+    else
+    {
+      clock->state[vpn] = CLOCKPRO_NONE;
+      clockpro_unlink(clock, vpn);
+    }
+    return virtualaddr;
+  }
+}
+
+// run_eviction_mglru: evicts the oldest page of the oldest generation
+// a page referenced since the last tick goes to the youngest generation instead
+int run_eviction_mglru(mglru *gens)
+{
+  if (gens->currsize == 0)
+  {
+    return -1;
+  }
+  while (true)
+  {
+    int sentinel = MGLRU_SENTINEL(gens, gens->minseq);
+    if (gens->size[sentinel - PAGES] == 0)
+    {
+      // cannot be the youngest generation, some page is resident
+      gens->minseq++;
+      continue;
+    }
+    int vpn = gens->prev[sentinel];
+    uint16_t virtualaddr = vpn << 6;
+    if (isreferenced_pte(gens->type, gens->vpt, virtualaddr))
+    {
+      unset_referencedpte(gens->type, gens->vpt, virtualaddr);
+      mglru_unlink(gens, vpn);
+      mglru_push(gens, vpn, gens->maxseq);
+      gens->stats.secondchances++;
+      continue;
+    }
+    gens->stats.evictions++;
+    gens->stats.evictedage += gens->maxseq - gens->seq[vpn];
+    mglru_unlink(gens, vpn);
+    gens->currsize--;
+    return virtualaddr;
+  }
+}
+
+// run_eviction_aging: evicts the page with the lowest counter, the last slot moves into its slot
+int run_eviction_aging(aging *counters)
+{
+  if (counters->currsize == 0)
+  {
+    return -1;
+  }
+  int slot = counters->heap[0];
+  uint16_t vpn = counters->vpnof[slot];
+  counters->stats.evictions++;
+  if (counters->age[slot] == 0)
+  {
+    counters->stats.idleevictions++;
+  }
+  counters->currsize--;
+  if (counters->currsize > 0)
+  {
+    aging_place(counters, 0, counters->heap[counters->currsize]);
+    aging_siftdown(counters, 0);
+  }
+
+  int last = counters->currsize;
+  if (slot != last)
+  {
+    counters->age[slot] = counters->age[last];
+    counters->loaded[slot] = counters->loaded[last];
+    counters->vpnof[slot] = counters->vpnof[last];
+    counters->slotof[counters->vpnof[slot]] = slot;
+    aging_place(counters, counters->heapindex[last], slot);
+  }
+  counters->slotof[vpn] = -1;
+  return vpn << 6;
+}
+
+// run_eviction_wsclock: makes one pass of the hand, evicts the first clean page out of the working set
+// dirty pages out of the working set get their writeback scheduled and are passed over,
+// returns -1 if the pass scheduled writebacks but found no clean page,
+// if it did neither every page is in the working set and the oldest one goes, a clean one if there is any
+int run_eviction_wsclock(wsclock *ws)
+{
+  if (ws->currsize == 0)
+  {
+    return -1;
+  }
+  int oldest = -1;
+  int oldestclean = -1;
+  int victim = -1;
+  for (int i = 0; i < ws->currsize && victim == -1; i++)
+  {
+    int vpn = ws->hand;
+    uint16_t virtualaddr = vpn << 6;
+    ws->hand = ws->next[vpn];
+    bool ismodified = ismodified_pte(ws->type, ws->vpt, virtualaddr);
+    if (ws->now - ws->lastuse[vpn] >= ws->tau)
+    {
+      if (!ismodified)
+      {
+        victim = vpn;
+      }
+      else if (!ws->queued[vpn])
+      {
+        ws->queued[vpn] = true;
+        ws->cleanqueue[ws->ncleans++] = vpn;
+        ws->stats.scheduled++;
+      }
+      continue;
+    }
+    if (oldest == -1 || ws->lastuse[vpn] < ws->lastuse[oldest])
+      oldest = vpn;
+    if (!ismodified && (oldestclean == -1 || ws->lastuse[vpn] < ws->lastuse[oldestclean]))
+      oldestclean = vpn;
+  }
+  if (victim == -1)
+  {
+    if (ws->ncleans > 0)
+    {
+      return -1;
+    }
+    victim = oldestclean != -1 ? oldestclean : oldest;
+  }
+  else
+  {
+    ws->stats.oldevictions++;
+  }
+
+  if (ws->next[victim] == victim)
+  {
+    ws->hand = -1;
+  }
+  else
+  {
+    if (ws->hand == victim)
+      ws->hand = ws->next[victim];
+    ws->next[ws->prev[victim]] = ws->next[victim];
+    ws->prev[ws->next[victim]] = ws->prev[victim];
+  }
+  ws->currsize--;
+  ws->stats.evictions++;
+  return victim << 6;
+}
+
+// run_eviction_lfu: evicts the oldest page of the lowest bucket
+int run_eviction_lfu(lfu *freqs)
+{
+  if (freqs->currsize == 0)
+  {
+    return -1;
+  }
+  int vpn = freqs->first[freqs->lowest];
+  uint32_t count = freqs->count[freqs->lowest];
+  freqs->stats.evictions++;
+  freqs->stats.evictedcount += count;
+  if (count == 0)
+  {
+    freqs->stats.coldevictions++;
+  }
+  lfu_detach(freqs, vpn);
+  freqs->currsize--;
+  return vpn << 6;
+}
+
+// run_eviction_adaptive: evicts the page the live policy picks, the other orders forget it as well
+int run_eviction_adaptive(adaptive *duel)
+{
+  if (duel->currsize == 0)
+  {
+    return -1;
   }
-}
\ No newline at end of file
+  int vpn;
+  switch (duel->live)
+  {
+  case ADAPTIVE_LRU:
+    vpn = duel->recency.tail;
+    break;
+  case ADAPTIVE_MRU:
+    vpn = duel->recency.head;
+    break;
+  default:
+    vpn = duel->frequency->first[duel->frequency->lowest];
+    break;
+  }
+  recency_remove(&(duel->recency), vpn);
+  lfu_detach(duel->frequency, vpn);
+  duel->frequency->currsize--;
+  duel->currsize--;
+  duel->stats.evictions[duel->live]++;
+  return vpn << 6;
+}
+
+void onloadpage(
+    void *vpt,
+    PAGETABLE type,
+    uint16_t virtualaddr,
+    bool ismodified)
+{
+  // this utility function sets the metabits
+  // for the loaded page
+  // it sets the valid bit to one
+  // it sets the referenced bit to one
+  // if the page was for write, sets the modified bit to one
+  set_validpte(type, vpt, virtualaddr);
+  set_referencedpte(type, vpt, virtualaddr);
+  if (ismodified)
+  {
+    set_modifiedpte(type, vpt, virtualaddr);
+  }
+}
+
+void writetopage(
+    page *frame,
+    uint16_t virtualaddr,
+    uint8_t value)
+{
+  uint16_t offset = virtualaddr & 0x003f;
+  frame->content[offset] = value;
+}
+
+bool cleanpage(
+    PAGETABLE type,
+    void *vpt,
+    uint16_t virtualaddr,
+    page *frame,
+    uint16_t framenumber,
+    swapspace *ss,
+    subpage *sp,
+    framehash *fh)
+{
+  uint16_t pageidx = SS_PAGEIDX(virtualaddr);
+  // a frame holding what it held at page-in only saw silent stores, swap is still current
+  if (!ismodified_pte(type, vpt, virtualaddr) || (fh != NULL && framehash_unchanged(fh, framenumber, frame)))
+  {
+    return false;
+  }
+  if (sp != NULL)
+    subpage_writeback(sp, ss, pageidx, framenumber, frame);
+  else
+    write_page(ss, pageidx, frame);
+  return true;
+}
+
+void onunloadpage(
+    PAGETABLE type,
+    void *vpt,
+    uint16_t virtualaddr,
+    page *frame,
+    uint16_t framenumber,
+    swapspace *ss,
+    subpage *sp,
+    framehash *fh)
+{
+  cleanpage(type, vpt, virtualaddr, frame, framenumber, ss, sp, fh);
+
+  // clear all the metabits
+  unset_validpte(type, vpt, virtualaddr);
+  unset_referencedpte(type, vpt, virtualaddr);
+  unset_modifiedpte(type, vpt, virtualaddr);
+}
+
+/**
+ * Algorithm Specific Constructors and Destructors
+ */
+fifo *new_fifo(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  fifo *newfifo = (fifo *)malloc(sizeof(fifo));
+  newfifo->head = NULL;
+  newfifo->currsize = 0;
+  newfifo->maxsize = fcount;
+  newfifo->type = type;
+  newfifo->vpt = vpt;
+  return newfifo;
+}
+
+void free_fifo(fifo *fifolist)
+{
+  if (fifolist)
+  {
+    free_algonode(fifolist->head);
+    free(fifolist);
+  }
+}
+
+sclock *new_sclock(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  sclock *newsclock = (sclock *)malloc(sizeof(sclock));
+  newsclock->head = NULL;
+  newsclock->currsize = 0;
+  newsclock->maxsize = fcount;
+  newsclock->type = type;
+  newsclock->vpt = vpt;
+  return newsclock;
+}
+
+void free_sclock(sclock *sclocklist)
+{
+  if (sclocklist)
+  {
+    free_algonode(sclocklist->head);
+    free(sclocklist);
+  }
+}
+
+eclock *new_eclock(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  eclock *neweclock = (eclock *)malloc(sizeof(eclock));
+  neweclock->head = NULL;
+  neweclock->currsize = 0;
+  neweclock->maxsize = fcount;
+  neweclock->type = type;
+  neweclock->vpt = vpt;
+  return neweclock;
+}
+
+void free_eclock(eclock *eclocklist)
+{
+  if (eclocklist)
+  {
+    free_algonode(eclocklist->head);
+    free(eclocklist);
+  }
+}
+
+lru *new_lru(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  lru *newlru = (lru *)malloc(sizeof(lru));
+  newlru->start = clock();
+  newlru->head = NULL;
+  newlru->currsize = 0;
+  newlru->maxsize = fcount;
+  newlru->type = type;
+  newlru->vpt = vpt;
+  return newlru;
+}
+
+void free_lru(lru *lrulist)
+{
+  if (lrulist)
+  {
+    free_algonode(lrulist->head);
+    free(lrulist);
+  }
+}
+
+void update_referencedtime(lru *list, uint16_t virtualaddr)
+{
+  algonode *curr = list->head;
+  uint16_t msb_virtualaddr = (virtualaddr & 0xffc0);
+  while (curr != NULL)
+  {
+    if (curr->msb_virtualaddr == msb_virtualaddr)
+    {
+      curr->lastreferenced = (double)(clock() - list->start);
+      return;
+    }
+    curr = curr->next;
+  }
+}
+
+opt *new_opt(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    const char *addrfile)
+{
+  opt *newopt = (opt *)malloc(sizeof(opt));
+  newopt->trace = new_nextuse(addrfile);
+  newopt->position = 0;
+  memcpy(newopt->nextref, newopt->trace->first, sizeof(newopt->nextref));
+  for (int i = 0; i < PAGES; i++)
+  {
+    newopt->heapindex[i] = -1;
+  }
+  newopt->currsize = 0;
+  newopt->maxsize = fcount;
+  newopt->type = type;
+  newopt->vpt = vpt;
+  return newopt;
+}
+
+void free_opt(opt *optheap)
+{
+  if (optheap)
+  {
+    for (int i = 0; i < optheap->currsize; i++)
+    {
+      free_algonode(optheap->heap[i]);
+    }
+    free_nextuse(optheap->trace);
+    free(optheap);
+  }
+}
+
+// opt_onreference: moves on to the next reference of the trace, a reference to virtualaddr
+// called for every reference before it is resolved, so that a page faulted in is inserted with its next use
+void opt_onreference(opt *optheap, uint16_t virtualaddr)
+{
+  uint16_t vpn = SS_PAGEIDX(virtualaddr);
+  uint32_t position = optheap->position++;
+  optheap->nextref[vpn] = position < optheap->trace->count ? optheap->trace->next[position] : NEXTUSE_NEVER;
+  if (optheap->heapindex[vpn] != -1)
+  {
+    // the page was due now, its next use can only be later
+    opt_siftup(optheap, optheap->heapindex[vpn]);
+  }
+}
+
+arc *new_arc(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  arc *newarc = (arc *)malloc(sizeof(arc));
+  for (int list = 0; list < ARC_LISTS; list++)
+  {
+    newarc->prev[PAGES + list] = PAGES + list;
+    newarc->next[PAGES + list] = PAGES + list;
+    newarc->size[list] = 0;
+  }
+  memset(newarc->where, ARC_NONE, sizeof(newarc->where));
+  newarc->p = 0;
+  newarc->pending = -1;
+  newarc->pendingb2 = false;
+  memset(&(newarc->stats), 0, sizeof(arcstats));
+  newarc->stats.stride = 1;
+  newarc->currsize = 0;
+  newarc->maxsize = fcount;
+  newarc->type = type;
+  newarc->vpt = vpt;
+  return newarc;
+}
+
+void free_arc(arc *arclist)
+{
+  free(arclist);
+}
+
+// arc_onmiss: adapts the target to a miss on virtualaddr, before the victim is picked
+// a miss on B1 means T1 was too small and moves the target up, a miss on B2 moves it down
+void arc_onmiss(arc *arclist, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  int b1 = arclist->size[ARC_B1];
+  int b2 = arclist->size[ARC_B2];
+  arcstats *stats = &(arclist->stats);
+  if (arclist->where[vpn] == ARC_B1)
+  {
+    int delta = b2 / b1 > 1 ? b2 / b1 : 1;
+    arclist->p = arclist->p + delta < arclist->maxsize ? arclist->p + delta : arclist->maxsize;
+    stats->ghosthits[0]++;
+  }
+  else if (arclist->where[vpn] == ARC_B2)
+  {
+    int delta = b1 / b2 > 1 ? b1 / b2 : 1;
+    arclist->p = arclist->p - delta > 0 ? arclist->p - delta : 0;
+    arclist->pendingb2 = true;
+    stats->ghosthits[1]++;
+  }
+  if (arclist->where[vpn] != ARC_NONE)
+  {
+    arc_unlink(arclist, vpn);
+    arclist->pending = vpn;
+  }
+
+  if (arclist->p < stats->pmin)
+    stats->pmin = arclist->p;
+  if (arclist->p > stats->pmax)
+    stats->pmax = arclist->p;
+  if (stats->misses % stats->stride == 0)
+  {
+    if (stats->nsamples == ARC_PSAMPLES)
+    {
+      // keep every other sample, the run so far is covered at half the rate
+      for (int i = 0; i < ARC_PSAMPLES / 2; i++)
+      {
+        stats->psamples[i] = stats->psamples[2 * i];
+      }
+      stats->nsamples = ARC_PSAMPLES / 2;
+      stats->stride *= 2;
+    }
+    if (stats->misses % stats->stride == 0)
+    {
+      stats->psamples[stats->nsamples++] = arclist->p;
+    }
+  }
+  stats->misses++;
+}
+
+// arc_onhit: a hit on T1 or T2 moves the page to the MRU end of T2
+void arc_onhit(arc *arclist, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  arc_unlink(arclist, vpn);
+  arc_pushmru(arclist, vpn, ARC_T2);
+}
+
+void print_arcstats(const arc *arclist)
+{
+  const arcstats *stats = &(arclist->stats);
+  printf("arc lists: T1 %d, T2 %d, B1 %d, B2 %d pages\n",
+         arclist->size[ARC_T1],
+         arclist->size[ARC_T2],
+         arclist->size[ARC_B1],
+         arclist->size[ARC_B2]);
+  printf("arc ghost hits: %lu on B1, %lu on B2 of %lu misses\n",
+         stats->ghosthits[0],
+         stats->ghosthits[1],
+         stats->misses);
+  printf("arc target p: final %d, min %d, max %d of %d frames\n",
+         arclist->p,
+         stats->pmin,
+         stats->pmax,
+         arclist->maxsize);
+  printf("arc target p every %lu misses:", stats->stride);
+  for (int i = 0; i < stats->nsamples; i++)
+  {
+    printf(" %d", stats->psamples[i]);
+  }
+  printf("\n");
+}
+
+clockpro *new_clockpro(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  clockpro *newclockpro = (clockpro *)malloc(sizeof(clockpro));
+  memset(newclockpro->state, CLOCKPRO_NONE, sizeof(newclockpro->state));
+  memset(newclockpro->test, 0, sizeof(newclockpro->test));
+  newclockpro->handhot = newclockpro->handcold = newclockpro->handtest = -1;
+  newclockpro->hot = 0;
+  newclockpro->cold = 0;
+  newclockpro->nonresident = 0;
+  // start with all frames for hot pages but one, test hits grow the cold share
+  newclockpro->coldtarget = 1;
+  memset(&(newclockpro->stats), 0, sizeof(clockprostats));
+  newclockpro->stats.coldmin = 1;
+  newclockpro->stats.coldmax = 1;
+  newclockpro->currsize = 0;
+  newclockpro->maxsize = fcount;
+  newclockpro->type = type;
+  newclockpro->vpt = vpt;
+  return newclockpro;
+}
+
+void free_clockpro(clockpro *clock)
+{
+  free(clock);
+}
+
+void print_clockprostats(const clockpro *clock)
+{
+  const clockprostats *stats = &(clock->stats);
+  printf("clockpro pages: %d hot, %d cold, %d non-resident on test\n",
+         clock->hot,
+         clock->cold,
+         clock->nonresident);
+  printf("clockpro cold target: final %d, min %d, max %d of %d frames\n",
+         clock->coldtarget,
+         stats->coldmin,
+         stats->coldmax,
+         clock->maxsize);
+  printf("clockpro hands: %lu promotions, %lu demotions, %lu test hits, %lu expired tests\n",
+         stats->promotions,
+         stats->demotions,
+         stats->testhits,
+         stats->testexpiries);
+}
+
+mglru *new_mglru(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int generations)
+{
+  mglru *newmglru = (mglru *)malloc(sizeof(mglru));
+  newmglru->generations = generations;
+  for (int i = 0; i < generations; i++)
+  {
+    newmglru->prev[PAGES + i] = PAGES + i;
+    newmglru->next[PAGES + i] = PAGES + i;
+    newmglru->size[i] = 0;
+  }
+  for (int i = 0; i < PAGES; i++)
+  {
+    newmglru->seq[i] = -1;
+  }
+  newmglru->minseq = 0;
+  newmglru->maxseq = 0;
+  memset(&(newmglru->stats), 0, sizeof(mglrustats));
+  newmglru->currsize = 0;
+  newmglru->maxsize = fcount;
+  newmglru->type = type;
+  newmglru->vpt = vpt;
+  return newmglru;
+}
+
+void free_mglru(mglru *gens)
+{
+  free(gens);
+}
+
+// mglru_age: opens a new youngest generation and moves the pages referenced since the previous tick into it
+// called on the tick, before the referenced bits are cleared
+void mglru_age(mglru *gens)
+{
+  if (gens->maxseq - gens->minseq + 1 == (unsigned long)gens->generations)
+  {
+    mglru_fold(gens);
+  }
+  gens->maxseq++;
+  gens->stats.agings++;
+  for (unsigned long seq = gens->minseq; seq < gens->maxseq; seq++)
+  {
+    int sentinel = MGLRU_SENTINEL(gens, seq);
+    int vpn = gens->next[sentinel];
+    while (vpn != sentinel)
+    {
+      int next = gens->next[vpn];
+      if (isreferenced_pte(gens->type, gens->vpt, vpn << 6))
+      {
+        mglru_unlink(gens, vpn);
+        mglru_push(gens, vpn, gens->maxseq);
+        gens->stats.promoted++;
+      }
+      vpn = next;
+    }
+  }
+}
+
+void print_mglrustats(const mglru *gens)
+{
+  const mglrustats *stats = &(gens->stats);
+  printf("mglru generations: %lu of %d, pages from youngest to oldest:",
+         gens->maxseq - gens->minseq + 1,
+         gens->generations);
+  for (unsigned long seq = gens->maxseq + 1; seq-- > gens->minseq;)
+  {
+    printf(" %d", gens->size[MGLRU_SENTINEL(gens, seq) - PAGES]);
+  }
+  printf("\n");
+  printf("mglru aging: %lu ticks, %lu pages promoted, %lu generations folded\n",
+         stats->agings,
+         stats->promoted,
+         stats->folds);
+  printf("mglru eviction: %lu pages, %lu second chances, avg age %.2f generations\n",
+         stats->evictions,
+         stats->secondchances,
+         stats->evictions ? (double)stats->evictedage / stats->evictions : 0.0);
+}
+
+aging *new_aging(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int bits)
+{
+  aging *newaging = (aging *)malloc(sizeof(aging));
+  newaging->bits = bits;
+  newaging->stamp = 0;
+  for (int i = 0; i < PAGES; i++)
+  {
+    newaging->slotof[i] = -1;
+  }
+  memset(&(newaging->stats), 0, sizeof(agingstats));
+  newaging->currsize = 0;
+  newaging->maxsize = fcount;
+  newaging->type = type;
+  newaging->vpt = vpt;
+  return newaging;
+}
+
+void free_aging(aging *counters)
+{
+  free(counters);
+}
+
+// aging_tick: shifts every counter right and ORs the page's referenced bit in at the top
+// the referenced bits are gathered first, the shift itself is a plain loop over dense arrays that vectorizes
+void aging_tick(aging *counters)
+{
+  int n = counters->currsize;
+  for (int slot = 0; slot < n; slot++)
+  {
+    uint16_t virtualaddr = counters->vpnof[slot] << 6;
+    counters->referenced[slot] = isreferenced_pte(counters->type, counters->vpt, virtualaddr);
+  }
+  uint32_t *age = counters->age;
+  const uint32_t *referenced = counters->referenced;
+  const int top = counters->bits - 1;
+  for (int slot = 0; slot < n; slot++)
+  {
+    age[slot] = (age[slot] >> 1) | (referenced[slot] << top);
+  }
+  // referenced pages moved above the others, the heap is rebuilt in linear time
+  for (int position = n / 2 - 1; position >= 0; position--)
+  {
+    aging_siftdown(counters, position);
+  }
+  counters->stats.ticks++;
+}
+
+void print_agingstats(const aging *counters)
+{
+  const agingstats *stats = &(counters->stats);
+  printf("aging counters: %d bits, %lu ticks\n", counters->bits, stats->ticks);
+  printf("aging victims: %lu pages, %lu not referenced for %d ticks\n",
+         stats->evictions,
+         stats->idleevictions,
+         counters->bits);
+}
+
+wsclock *new_wsclock(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int tau)
+{
+  wsclock *newwsclock = (wsclock *)malloc(sizeof(wsclock));
+  newwsclock->tau = tau;
+  newwsclock->now = 0;
+  newwsclock->hand = -1;
+  memset(newwsclock->lastuse, 0, sizeof(newwsclock->lastuse));
+  newwsclock->window = (uint16_t *)malloc(sizeof(uint16_t) * tau);
+  newwsclock->wssize = 0;
+  newwsclock->ncleans = 0;
+  memset(newwsclock->queued, 0, sizeof(newwsclock->queued));
+  memset(&(newwsclock->stats), 0, sizeof(wsclockstats));
+  newwsclock->stats.stride = 1;
+  newwsclock->currsize = 0;
+  newwsclock->maxsize = fcount;
+  newwsclock->type = type;
+  newwsclock->vpt = vpt;
+  return newwsclock;
+}
+
+void free_wsclock(wsclock *ws)
+{
+  if (ws)
+  {
+    free(ws->window);
+    free(ws);
+  }
+}
+
+// wsclock_onreference: advances virtual time by a reference to virtualaddr and keeps the working set up to date
+// called for every reference before it is resolved
+void wsclock_onreference(wsclock *ws, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  unsigned long slot = ws->now % ws->tau;
+  if (ws->now >= ws->tau)
+  {
+    // the reference tau ago leaves the window, and its page with it unless referenced since
+    int leaving = ws->window[slot];
+    if (ws->lastuse[leaving] == ws->now - ws->tau + 1)
+    {
+      ws->wssize--;
+    }
+  }
+  if (ws->lastuse[vpn] == 0 || ws->now - ws->lastuse[vpn] >= ws->tau - 1)
+  {
+    ws->wssize++;
+  }
+  ws->window[slot] = vpn;
+  ws->now++;
+  ws->lastuse[vpn] = ws->now;
+
+  wsclockstats *stats = &(ws->stats);
+  stats->wssum += ws->wssize;
+  if (ws->wssize > stats->wsmax)
+    stats->wsmax = ws->wssize;
+  if (ws->wssize > ws->maxsize)
+    stats->wsover++;
+  if ((ws->now - 1) % stats->stride == 0)
+  {
+    if (stats->nsamples == WSCLOCK_SAMPLES)
+    {
+      // keep every other sample, the run so far is covered at half the rate
+      for (int i = 0; i < WSCLOCK_SAMPLES / 2; i++)
+      {
+        stats->wssamples[i] = stats->wssamples[2 * i];
+      }
+      stats->nsamples = WSCLOCK_SAMPLES / 2;
+      stats->stride *= 2;
+    }
+    if ((ws->now - 1) % stats->stride == 0)
+    {
+      stats->wssamples[stats->nsamples++] = ws->wssize;
+    }
+  }
+}
+
+void print_wsclockstats(const wsclock *ws)
+{
+  const wsclockstats *stats = &(ws->stats);
+  printf("wsclock window: %lu references\n", ws->tau);
+  printf("wsclock working set: avg %.2f, max %d pages, larger than the %d frames at %.2f%% of references\n",
+         ws->now ? (double)stats->wssum / ws->now : 0.0,
+         stats->wsmax,
+         ws->maxsize,
+         ws->now ? 100.0 * stats->wsover / ws->now : 0.0);
+  printf("wsclock working set every %lu references:", stats->stride);
+  for (int i = 0; i < stats->nsamples; i++)
+  {
+    printf(" %d", stats->wssamples[i]);
+  }
+  printf("\n");
+  printf("wsclock evictions: %lu pages, %lu out of the working set, %lu writebacks scheduled\n",
+         stats->evictions,
+         stats->oldevictions,
+         stats->scheduled);
+}
+
+lfu *new_lfu(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  lfu *newlfu = (lfu *)malloc(sizeof(lfu));
+  newlfu->lowest = -1;
+  newlfu->nbuckets = 0;
+  // every bucket starts out in the pool
+  for (int i = 0; i < PAGES; i++)
+  {
+    newlfu->higher[i] = i + 1 < PAGES ? i + 1 : -1;
+    newlfu->bucketof[i] = -1;
+  }
+  newlfu->freebuckets = 0;
+  memset(&(newlfu->stats), 0, sizeof(lfustats));
+  newlfu->currsize = 0;
+  newlfu->maxsize = fcount;
+  newlfu->type = type;
+  newlfu->vpt = vpt;
+  return newlfu;
+}
+
+void free_lfu(lfu *freqs)
+{
+  free(freqs);
+}
+
+// lfu_onhit: moves the page one count up, into the next bucket if it holds that count
+// a page alone in its bucket takes the bucket along instead
+void lfu_onhit(lfu *freqs, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  int bucket = freqs->bucketof[vpn];
+  if (freqs->count[bucket] == UINT32_MAX)
+  {
+    return;
+  }
+  uint32_t count = freqs->count[bucket] + 1;
+  int higher = freqs->higher[bucket];
+  if (higher != -1 && freqs->count[higher] == count)
+  {
+    lfu_detach(freqs, vpn);
+    lfu_append(freqs, higher, vpn);
+  }
+  else if (freqs->first[bucket] == vpn && freqs->last[bucket] == vpn)
+  {
+    freqs->count[bucket] = count;
+  }
+  else
+  {
+    int newbucket = lfu_newbucket(freqs, count, bucket);
+    lfu_detach(freqs, vpn);
+    lfu_append(freqs, newbucket, vpn);
+  }
+}
+
+// lfu_decay: halves every count, so that pages hot long ago stop outweighing the ones hot now
+// halving keeps the buckets in order, a bucket whose count meets the one below joins it behind its pages
+void lfu_decay(lfu *freqs)
+{
+  int bucket = freqs->lowest;
+  while (bucket != -1)
+  {
+    int higher = freqs->higher[bucket];
+    int lower = freqs->lower[bucket];
+    uint32_t count = freqs->count[bucket] >> 1;
+    if (lower != -1 && freqs->count[lower] == count)
+    {
+      for (int vpn = freqs->first[bucket]; vpn != -1; vpn = freqs->next[vpn])
+      {
+        freqs->bucketof[vpn] = lower;
+      }
+      freqs->next[freqs->last[lower]] = freqs->first[bucket];
+      freqs->prev[freqs->first[bucket]] = freqs->last[lower];
+      freqs->last[lower] = freqs->last[bucket];
+      lfu_freebucket(freqs, bucket);
+    }
+    else
+    {
+      freqs->count[bucket] = count;
+    }
+    bucket = higher;
+  }
+  freqs->stats.decays++;
+}
+
+void print_lfustats(const lfu *freqs)
+{
+  const lfustats *stats = &(freqs->stats);
+  printf("lfu decays: %lu ticks halved every count\n", stats->decays);
+  printf("lfu buckets: %d in use, at most %d\n", freqs->nbuckets, stats->maxbuckets);
+  printf("lfu victims: %lu pages, avg count %.2f, %lu decayed to 0\n",
+         stats->evictions,
+         stats->evictions ? (double)stats->evictedcount / stats->evictions : 0.0,
+         stats->coldevictions);
+}
+
+adaptive *new_adaptive(
+    PAGETABLE type,
+    void *vpt,
+    int fcount)
+{
+  adaptive *newadaptive = (adaptive *)malloc(sizeof(adaptive));
+  newadaptive->live = ADAPTIVE_LRU;
+  newadaptive->now = 0;
+  recency_init(&(newadaptive->recency));
+  newadaptive->frequency = new_lfu(type, vpt, fcount);
+  // few frames are sampled more densely, a shadow too small for its policy to matter tells nothing
+  newadaptive->sampleratio = ADAPTIVE_SAMPLE_RATIO;
+  while (newadaptive->sampleratio > 1 && fcount / newadaptive->sampleratio < ADAPTIVE_MIN_SHADOW)
+  {
+    newadaptive->sampleratio /= 2;
+  }
+  // a multiplicative hash spreads the sample over the address space
+  newadaptive->nsampled = 0;
+  for (int i = 0; i < PAGES; i++)
+  {
+    newadaptive->sampled[i] = (((uint32_t)i * 2654435761u) >> 16 & (newadaptive->sampleratio - 1)) == 0;
+    if (newadaptive->sampled[i])
+      newadaptive->nsampled++;
+  }
+  newadaptive->shadowsize = fcount / newadaptive->sampleratio;
+  recency_init(&(newadaptive->shadowlru));
+  recency_init(&(newadaptive->shadowmru));
+  newadaptive->shadowlfu = new_lfu(type, vpt, newadaptive->shadowsize);
+  newadaptive->epochreferences = 0;
+  memset(newadaptive->epochmisses, 0, sizeof(newadaptive->epochmisses));
+  memset(newadaptive->score, 0, sizeof(newadaptive->score));
+  memset(&(newadaptive->stats), 0, sizeof(adaptivestats));
+  newadaptive->currsize = 0;
+  newadaptive->maxsize = fcount;
+  newadaptive->type = type;
+  newadaptive->vpt = vpt;
+  return newadaptive;
+}
+
+void free_adaptive(adaptive *duel)
+{
+  if (duel)
+  {
+    free_lfu(duel->frequency);
+    free_lfu(duel->shadowlfu);
+    free(duel);
+  }
+}
+
+// adaptive_onreference: runs the reference through every shadow if its page is sampled
+// called for every reference before it is resolved
+void adaptive_onreference(adaptive *duel, uint16_t virtualaddr)
+{
+  int vpn = SS_PAGEIDX(virtualaddr);
+  duel->now++;
+  if (!duel->sampled[vpn])
+  {
+    return;
+  }
+  duel->stats.sampledreferences++;
+
+  if (!duel->shadowlru.member[vpn])
+  {
+    duel->epochmisses[ADAPTIVE_LRU]++;
+    duel->stats.shadowmisses[ADAPTIVE_LRU]++;
+    if (duel->shadowlru.size == duel->shadowsize)
+      recency_remove(&(duel->shadowlru), duel->shadowlru.tail);
+  }
+  recency_touch(&(duel->shadowlru), vpn);
+
+  if (!duel->shadowmru.member[vpn])
+  {
+    duel->epochmisses[ADAPTIVE_MRU]++;
+    duel->stats.shadowmisses[ADAPTIVE_MRU]++;
+    if (duel->shadowmru.size == duel->shadowsize)
+      recency_remove(&(duel->shadowmru), duel->shadowmru.head);
+  }
+  recency_touch(&(duel->shadowmru), vpn);
+
+  if (duel->shadowlfu->bucketof[vpn] == -1)
+  {
+    duel->epochmisses[ADAPTIVE_LFU]++;
+    duel->stats.shadowmisses[ADAPTIVE_LFU]++;
+    if (duel->shadowlfu->currsize == duel->shadowsize)
+      run_eviction_lfu(duel->shadowlfu);
+    lfu_insert(duel->shadowlfu, virtualaddr);
+  }
+  else
+  {
+    lfu_onhit(duel->shadowlfu, virtualaddr);
+  }
+
+  duel->epochreferences++;
+  if (duel->epochreferences == ADAPTIVE_EPOCH)
+  {
+    adaptive_endepoch(duel);
+  }
+}
+
+// adaptive_onhit: keeps the resident pages in recency and frequency order, whichever policy is live
+void adaptive_onhit(adaptive *duel, uint16_t virtualaddr)
+{
+  recency_touch(&(duel->recency), SS_PAGEIDX(virtualaddr));
+  lfu_onhit(duel->frequency, virtualaddr);
+}
+
+// adaptive_tick: decays the counts of the live and shadow frequency orders alike
+void adaptive_tick(adaptive *duel)
+{
+  lfu_decay(duel->frequency);
+  lfu_decay(duel->shadowlfu);
+}
+
+void print_adaptivestats(const adaptive *duel)
+{
+  static const char *names[ADAPTIVE_POLICIES] = {"LRU", "MRU", "LFU"};
+  const adaptivestats *stats = &(duel->stats);
+  printf("adaptive shadows: %d of %d pages sampled, %d frames each, %lu sampled references in %lu epochs\n",
+         duel->nsampled,
+         PAGES,
+         duel->shadowsize,
+         stats->sampledreferences,
+         stats->epochs);
+  printf("adaptive shadow miss rates:");
+  for (int policy = 0; policy < ADAPTIVE_POLICIES; policy++)
+  {
+    printf(" %s %.2f%%",
+           names[policy],
+           stats->sampledreferences ? 100.0 * stats->shadowmisses[policy] / stats->sampledreferences : 0.0);
+  }
+  printf("\n");
+  printf("adaptive evictions:");
+  for (int policy = 0; policy < ADAPTIVE_POLICIES; policy++)
+  {
+    printf(" %s %lu", names[policy], stats->evictions[policy]);
+  }
+  printf(", %s live at the end\n", names[duel->live]);
+  printf("adaptive switches: %lu\n", stats->switches);
+  for (unsigned long i = 0; i < stats->switches && i < ADAPTIVE_LOG; i++)
+  {
+    printf("adaptive switch at reference %lu: %s -> %s\n",
+           stats->log[i].reference,
+           names[stats->log[i].from],
+           names[stats->log[i].to]);
+  }
+  if (stats->switches > ADAPTIVE_LOG)
+  {
+    printf("adaptive switches not logged: %lu\n", stats->switches - ADAPTIVE_LOG);
+  }
+}
+
+void init_algonode(
+    algonode **node,
+    pagetableentry *pte,
+    uint16_t msb_va,
+    algonode *next)
+{
+#ifdef MEMSIM_ASSERTIONS
+  assert(node != NULL);
+#endif
+  (*node)->pte_ref = pte;
+  (*node)->msb_virtualaddr = msb_va;
+  (*node)->next = next;
+}
+
+void free_algonode(algonode *node)
+{
+  if (node)
+  {
+    if (node->next)
+    {
+      free_algonode(node->next);
+    }
+    free(node);
+  }
+}
+
+/**
+ * Frame allocation
+ */
+framepool *new_framepool(int framecount, standby *sb)
+{
+  framepool *frames = (framepool *)malloc(sizeof(framepool));
+  frames->framecount = framecount;
+  frames->sharers = (int *)calloc(framecount, sizeof(int));
+  frames->firstpage = (int *)malloc(sizeof(int) * framecount);
+  frames->freeframes = (int *)malloc(sizeof(int) * framecount);
+  for (int i = 0; i < framecount; i++)
+  {
+    frames->firstpage[i] = -1;
+    // the lowest frame sits on top of the stack
+    frames->freeframes[i] = framecount - 1 - i;
+  }
+  for (int i = 0; i < PAGES; i++)
+  {
+    frames->nextpage[i] = -1;
+  }
+  frames->nfree = framecount;
+  frames->heldframes = (int *)malloc(sizeof(int) * framecount);
+  frames->nheld = 0;
+  frames->sb = sb;
+  return frames;
+}
+
+void free_framepool(framepool *frames)
+{
+  if (frames)
+  {
+    free(frames->sharers);
+    free(frames->firstpage);
+    free(frames->freeframes);
+    free(frames->heldframes);
+    free(frames);
+  }
+}
+
+// take_free: takes the free frame at pos off the free stack, the frames above it move down
+static uint16_t take_free(framepool *frames, int pos)
+{
+  uint16_t frame = (uint16_t)frames->freeframes[pos];
+  memmove(frames->freeframes + pos, frames->freeframes + pos + 1, sizeof(int) * (frames->nfree - pos - 1));
+  frames->nfree--;
+  if (frames->sb != NULL)
+  {
+    standby_repurpose(frames->sb, frame);
+  }
+  return frame;
+}
+
+uint16_t acquire_frame(framepool *frames)
+{
+#ifdef MEMSIM_ASSERTIONS
+  assert(frames->nfree > 0);
+#endif
+  int pos = frames->nfree - 1;
+  if (frames->sb != NULL)
+  {
+    // free frames without standby contents go first, then the one whose page was evicted the longest ago
+    while (pos >= 0 && frames->sb->pageof[frames->freeframes[pos]] != -1)
+    {
+      pos--;
+    }
+    if (pos < 0)
+    {
+      return claim_frame(frames, (uint16_t)frames->sb->oldest);
+    }
+  }
+  return take_free(frames, pos);
+}
+
+// claim_frame: takes the given free frame, used for a standby page that is resident again in its old frame
+uint16_t claim_frame(framepool *frames, const uint16_t frame)
+{
+  int pos = frames->nfree - 1;
+  while (frames->freeframes[pos] != frame)
+  {
+#ifdef MEMSIM_ASSERTIONS
+    assert(pos > 0);
+#endif
+    pos--;
+  }
+  return take_free(frames, pos);
+}
+
+void map_frame(framepool *frames, const uint16_t frame, const uint16_t vpn)
+{
+  frames->nextpage[vpn] = frames->firstpage[frame];
+  frames->firstpage[frame] = vpn;
+  frames->sharers[frame]++;
+}
+
+// unmap_frame: returns true if vpn was the last page mapped to frame, which is free from now on
+bool unmap_frame(framepool *frames, const uint16_t frame, const uint16_t vpn)
+{
+  int *link = frames->firstpage + frame;
+  while (*link != vpn)
+  {
+#ifdef MEMSIM_ASSERTIONS
+    assert(*link != -1);
+#endif
+    link = frames->nextpage + *link;
+  }
+  *link = frames->nextpage[vpn];
+  frames->nextpage[vpn] = -1;
+  frames->sharers[frame]--;
+  if (frames->sharers[frame] != 0)
+  {
+    return false;
+  }
+  frames->freeframes[frames->nfree] = frame;
+  frames->nfree++;
+  return true;
+}
+
+// hold_frame: holds back a free frame, the next one acquire_frame would hand out
+void hold_frame(framepool *frames)
+{
+  frames->heldframes[frames->nheld++] = acquire_frame(frames);
+}
+
+// release_frame: puts the frame held back last on the free stack
+void release_frame(framepool *frames)
+{
+#ifdef MEMSIM_ASSERTIONS
+  assert(frames->nheld > 0);
+#endif
+  frames->nheld--;
+  frames->freeframes[frames->nfree] = frames->heldframes[frames->nheld];
+  frames->nfree++;
+}
+
+/**
+ * Built-in policies, the simulator reaches each algorithm through its replacementpolicy
+ */
+// new_node: the node of a page just brought in for the list-based algorithms
+static algonode *new_node(uint16_t virtualaddr, pagetableentry *pte)
+{
+  algonode *node = (algonode *)malloc(sizeof(algonode));
+  init_algonode(&node, pte, (virtualaddr & 0xffc0), NULL);
+  return node;
+}
+
+static void *fifo_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_fifo(type, vpt, fcount);
+}
+
+static void fifo_destroy(void *state)
+{
+  free_fifo((fifo *)state);
+}
+
+static int fifo_choose_victim(void *state)
+{
+  return node_victim(run_eviction_fifo((fifo *)state));
+}
+
+// basealgo_on_load: FIFO and both clocks append the page to their list
+static void basealgo_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  basealgo *list = (basealgo *)state;
+  append_node(&(list->head), new_node(virtualaddr, pte));
+  list->currsize++;
+}
+
+static void *sclock_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_sclock(type, vpt, fcount);
+}
+
+static void sclock_destroy(void *state)
+{
+  free_sclock((sclock *)state);
+}
+
+static int sclock_choose_victim(void *state)
+{
+  return node_victim(run_eviction_sclock((sclock *)state));
+}
+
+static void *eclock_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_eclock(type, vpt, fcount);
+}
+
+static void eclock_destroy(void *state)
+{
+  free_eclock((eclock *)state);
+}
+
+static int eclock_choose_victim(void *state)
+{
+  return node_victim(run_eviction_eclock((eclock *)state));
+}
+
+static void *lru_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_lru(type, vpt, fcount);
+}
+
+static void lru_destroy(void *state)
+{
+  free_lru((lru *)state);
+}
+
+static void lru_on_hit(void *state, uint16_t virtualaddr)
+{
+  update_referencedtime((lru *)state, virtualaddr);
+}
+
+static int lru_choose_victim(void *state)
+{
+  return node_victim(run_eviction_lru((lru *)state));
+}
+
+static void lru_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  lru *lrulist = (lru *)state;
+  algonode *node = new_node(virtualaddr, pte);
+  node->lastreferenced = (double)(clock() - lrulist->start);
+  append_node(&(lrulist->head), node);
+  lrulist->currsize++;
+}
+
+static void *opt_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_opt(type, vpt, fcount, args->addrfile);
+}
+
+static void opt_destroy(void *state)
+{
+  free_opt((opt *)state);
+}
+
+static void opt_on_reference(void *state, uint16_t virtualaddr)
+{
+  opt_onreference((opt *)state, virtualaddr);
+}
+
+static int opt_choose_victim(void *state)
+{
+  return node_victim(run_eviction_opt((opt *)state));
+}
+
+// opt_on_load: kept by next use instead of in a list
+static void opt_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  opt_push((opt *)state, new_node(virtualaddr, pte));
+}
+
+static void *arc_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_arc(type, vpt, fcount);
+}
+
+static void arc_destroy(void *state)
+{
+  free_arc((arc *)state);
+}
+
+static void arc_on_hit(void *state, uint16_t virtualaddr)
+{
+  arc_onhit((arc *)state, virtualaddr);
+}
+
+// arc_on_fault: a miss on a ghost moves the target before the victim is picked
+static void arc_on_fault(void *state, uint16_t virtualaddr)
+{
+  arc_onmiss((arc *)state, virtualaddr);
+}
+
+static int arc_choose_victim(void *state)
+{
+  return run_eviction_arc((arc *)state);
+}
+
+static void arc_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  arc_insert((arc *)state, virtualaddr);
+}
+
+static void arc_print_stats(const void *state)
+{
+  print_arcstats((const arc *)state);
+}
+
+static void *clockpro_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_clockpro(type, vpt, fcount);
+}
+
+static void clockpro_destroy(void *state)
+{
+  free_clockpro((clockpro *)state);
+}
+
+static int clockpro_choose_victim(void *state)
+{
+  return run_eviction_clockpro((clockpro *)state);
+}
+
+// clockpro_on_load: the fault is the first access, only a later reference tells the page is reused
+static void clockpro_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  clockpro *clock = (clockpro *)state;
+  unset_referencedpte(clock->type, clock->vpt, virtualaddr);
+  clockpro_insert(clock, virtualaddr);
+}
+
+static void clockpro_print_stats(const void *state)
+{
+  print_clockprostats((const clockpro *)state);
+}
+
+static void *mglru_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_mglru(type, vpt, fcount, args->generations);
+}
+
+static void mglru_destroy(void *state)
+{
+  free_mglru((mglru *)state);
+}
+
+static int mglru_choose_victim(void *state)
+{
+  return run_eviction_mglru((mglru *)state);
+}
+
+static void mglru_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  mglru *gens = (mglru *)state;
+  mglru_push(gens, SS_PAGEIDX(virtualaddr), gens->maxseq);
+  gens->currsize++;
+}
+
+static void mglru_on_tick(void *state)
+{
+  mglru_age((mglru *)state);
+}
+
+static void mglru_print_stats(const void *state)
+{
+  print_mglrustats((const mglru *)state);
+}
+
+static void *aging_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_aging(type, vpt, fcount, args->agebits);
+}
+
+static void aging_destroy(void *state)
+{
+  free_aging((aging *)state);
+}
+
+static int aging_choose_victim(void *state)
+{
+  return run_eviction_aging((aging *)state);
+}
+
+static void aging_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  aging_insert((aging *)state, virtualaddr);
+}
+
+static void aging_on_tick(void *state)
+{
+  aging_tick((aging *)state);
+}
+
+static void aging_print_stats(const void *state)
+{
+  print_agingstats((const aging *)state);
+}
+
+static void *wsclock_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_wsclock(type, vpt, fcount, args->tau);
+}
+
+static void wsclock_destroy(void *state)
+{
+  free_wsclock((wsclock *)state);
+}
+
+static void wsclock_on_reference(void *state, uint16_t virtualaddr)
+{
+  wsclock_onreference((wsclock *)state, virtualaddr);
+}
+
+static int wsclock_choose_victim(void *state)
+{
+  return run_eviction_wsclock((wsclock *)state);
+}
+
+static void wsclock_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  wsclock_insert((wsclock *)state, virtualaddr);
+}
+
+// wsclock_writebacks: hands over the pages the hand queued, they leave the queue
+static int wsclock_writebacks(void *state, uint16_t *pages)
+{
+  wsclock *ws = (wsclock *)state;
+  int count = ws->ncleans;
+  for (int i = 0; i < count; i++)
+  {
+    ws->queued[ws->cleanqueue[i]] = false;
+    pages[i] = ws->cleanqueue[i] << 6;
+  }
+  ws->ncleans = 0;
+  return count;
+}
+
+static void wsclock_print_stats(const void *state)
+{
+  print_wsclockstats((const wsclock *)state);
+}
+
+static void *lfu_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_lfu(type, vpt, fcount);
+}
+
+static void lfu_destroy(void *state)
+{
+  free_lfu((lfu *)state);
+}
+
+static void lfu_on_hit(void *state, uint16_t virtualaddr)
+{
+  lfu_onhit((lfu *)state, virtualaddr);
+}
+
+static int lfu_choose_victim(void *state)
+{
+  return run_eviction_lfu((lfu *)state);
+}
+
+static void lfu_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  lfu_insert((lfu *)state, virtualaddr);
+}
+
+static void lfu_on_tick(void *state)
+{
+  lfu_decay((lfu *)state);
+}
+
+static void lfu_print_stats(const void *state)
+{
+  print_lfustats((const lfu *)state);
+}
+
+static void *adaptive_create(PAGETABLE type, void *vpt, int fcount, const cmd_args *args)
+{
+  return new_adaptive(type, vpt, fcount);
+}
+
+static void adaptive_destroy(void *state)
+{
+  free_adaptive((adaptive *)state);
+}
+
+static void adaptive_on_reference(void *state, uint16_t virtualaddr)
+{
+  adaptive_onreference((adaptive *)state, virtualaddr);
+}
+
+static void adaptive_on_hit(void *state, uint16_t virtualaddr)
+{
+  adaptive_onhit((adaptive *)state, virtualaddr);
+}
+
+static int adaptive_choose_victim(void *state)
+{
+  return run_eviction_adaptive((adaptive *)state);
+}
+
+static void adaptive_on_load(void *state, uint16_t virtualaddr, pagetableentry *pte)
+{
+  adaptive_insert((adaptive *)state, virtualaddr);
+}
+
+static void adaptive_on_tick(void *state)
+{
+  adaptive_tick((adaptive *)state);
+}
+
+static void adaptive_print_stats(const void *state)
+{
+  print_adaptivestats((const adaptive *)state);
+}
+
+static const replacementpolicy builtinpolicies[] = {
+    [FIFO] = {
+        .name = "FIFO",
+        .create = fifo_create,
+        .destroy = fifo_destroy,
+        .choose_victim = fifo_choose_victim,
+        .on_load = basealgo_on_load},
+    [LRU] = {
+        .name = "LRU",
+        .create = lru_create,
+        .destroy = lru_destroy,
+        .on_hit = lru_on_hit,
+        .choose_victim = lru_choose_victim,
+        .on_load = lru_on_load},
+    [CLOCK] = {
+        .name = "CLOCK",
+        .create = sclock_create,
+        .destroy = sclock_destroy,
+        .choose_victim = sclock_choose_victim,
+        .on_load = basealgo_on_load},
+    [ECLOCK] = {
+        .name = "ECLOCK",
+        .create = eclock_create,
+        .destroy = eclock_destroy,
+        .choose_victim = eclock_choose_victim,
+        .on_load = basealgo_on_load},
+    [OPT] = {
+        .name = "OPT",
+        .create = opt_create,
+        .destroy = opt_destroy,
+        .on_reference = opt_on_reference,
+        .choose_victim = opt_choose_victim,
+        .on_load = opt_on_load},
+    [ARC] = {
+        .name = "ARC",
+        .create = arc_create,
+        .destroy = arc_destroy,
+        .on_hit = arc_on_hit,
+        .on_fault = arc_on_fault,
+        .choose_victim = arc_choose_victim,
+        .on_load = arc_on_load,
+        .print_stats = arc_print_stats},
+    [CLOCKPRO] = {
+        .name = "CLOCKPRO",
+        .create = clockpro_create,
+        .destroy = clockpro_destroy,
+        .choose_victim = clockpro_choose_victim,
+        .on_load = clockpro_on_load,
+        .print_stats = clockpro_print_stats},
+    [MGLRU] = {
+        .name = "MGLRU",
+        .create = mglru_create,
+        .destroy = mglru_destroy,
+        .choose_victim = mglru_choose_victim,
+        .on_load = mglru_on_load,
+        .on_tick = mglru_on_tick,
+        .print_stats = mglru_print_stats},
+    [AGING] = {
+        .name = "AGING",
+        .create = aging_create,
+        .destroy = aging_destroy,
+        .choose_victim = aging_choose_victim,
+        .on_load = aging_on_load,
+        .on_tick = aging_on_tick,
+        .print_stats = aging_print_stats},
+    [WSCLOCK] = {
+        .name = "WSCLOCK",
+        .create = wsclock_create,
+        .destroy = wsclock_destroy,
+        .on_reference = wsclock_on_reference,
+        .choose_victim = wsclock_choose_victim,
+        .on_load = wsclock_on_load,
+        .writebacks = wsclock_writebacks,
+        .print_stats = wsclock_print_stats},
+    [LFU] = {
+        .name = "LFU",
+        .create = lfu_create,
+        .destroy = lfu_destroy,
+        .on_hit = lfu_on_hit,
+        .choose_victim = lfu_choose_victim,
+        .on_load = lfu_on_load,
+        .on_tick = lfu_on_tick,
+        .print_stats = lfu_print_stats},
+    [ADAPTIVE] = {
+        .name = "ADAPTIVE",
+        .create = adaptive_create,
+        .destroy = adaptive_destroy,
+        .on_reference = adaptive_on_reference,
+        .on_hit = adaptive_on_hit,
+        .choose_victim = adaptive_choose_victim,
+        .on_load = adaptive_on_load,
+        .on_tick = adaptive_on_tick,
+        .print_stats = adaptive_print_stats},
+};
+
+// get_policy: the hooks of a built-in algorithm, NULL for anything else
+const replacementpolicy *get_policy(ALGO algo)
+{
+  if (algo < FIFO || algo > ADAPTIVE)
+  {
+    return NULL;
+  }
+  return builtinpolicies + algo;
+}
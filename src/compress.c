@@ -0,0 +1,107 @@
+#include <string.h>
+
+#include "compress.h"
+
+// flush_literals: emits the pending literal run ending right before end
+static int flush_literals(const uint8_t *src, int start, int end, uint8_t *out, int outsize)
+{
+  while (start < end)
+  {
+    int run = end - start > COMPRESS_MAX_LITERALS ? COMPRESS_MAX_LITERALS : end - start;
+    out[outsize++] = (uint8_t)(run - 1);
+    memcpy(out + outsize, src + start, run);
+    outsize += run;
+    start += run;
+  }
+  return outsize;
+}
+
+int compress_page(const page *pg, uint8_t *out)
+{
+  const uint8_t *src = pg->content;
+  int outsize = 0;
+  int literalstart = 0;
+  int i = 0;
+  while (i < PAGESIZE)
+  {
+    // greedy search for the longest match behind i
+    int bestlength = 0;
+    int bestdistance = 0;
+    int window = i > COMPRESS_MAX_DISTANCE ? COMPRESS_MAX_DISTANCE : i;
+    for (int distance = 1; distance <= window; distance++)
+    {
+      int length = 0;
+      while (i + length < PAGESIZE && length < COMPRESS_MAX_MATCH && src[i + length - distance] == src[i + length])
+      {
+        length++;
+      }
+      if (length > bestlength)
+      {
+        bestlength = length;
+        bestdistance = distance;
+      }
+    }
+
+    if (bestlength >= COMPRESS_MIN_MATCH)
+    {
+      outsize = flush_literals(src, literalstart, i, out, outsize);
+      out[outsize++] = (uint8_t)(0x80 | (bestlength - COMPRESS_MIN_MATCH));
+      out[outsize++] = (uint8_t)bestdistance;
+      i += bestlength;
+      literalstart = i;
+    }
+    else
+    {
+      i++;
+    }
+  }
+  return flush_literals(src, literalstart, PAGESIZE, out, outsize);
+}
+
+bool decompress_page(const uint8_t *in, const int size, page *pg)
+{
+  uint8_t *dst = pg->content;
+  int produced = 0;
+  int consumed = 0;
+  while (consumed < size)
+  {
+    uint8_t control = in[consumed++];
+    if (control & 0x80)
+    {
+      int length = (control & 0x7f) + COMPRESS_MIN_MATCH;
+      if (consumed >= size)
+        return false;
+      int distance = in[consumed++];
+      if (distance == 0 || distance > produced || produced + length > PAGESIZE)
+        return false;
+      // byte by byte, the match may overlap what it produces
+      for (int j = 0; j < length; j++, produced++)
+      {
+        dst[produced] = dst[produced - distance];
+      }
+    }
+    else
+    {
+      int run = control + 1;
+      if (consumed + run > size || produced + run > PAGESIZE)
+        return false;
+      memcpy(dst + produced, in + consumed, run);
+      consumed += run;
+      produced += run;
+    }
+  }
+  return produced == PAGESIZE;
+}
+
+bool is_samefilled(const page *pg, uint8_t *value)
+{
+  for (int i = 1; i < PAGESIZE; i++)
+  {
+    if (pg->content[i] != pg->content[0])
+    {
+      return false;
+    }
+  }
+  *value = pg->content[0];
+  return true;
+}
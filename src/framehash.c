@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "framehash.h"
+
+// hash_page: 64-bit multiply-xorshift hash over the page words
+uint64_t hash_page(const page *pg)
+{
+  uint64_t hash = 0x9e3779b97f4a7c15ULL;
+  for (int i = 0; i < PAGESIZE; i += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, pg->content + i, sizeof(uint64_t));
+    hash ^= word;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+  }
+  return hash;
+}
+
+framehash *new_framehash(int framecount)
+{
+  framehash *fh = (framehash *)malloc(sizeof(framehash));
+  fh->framecount = framecount;
+  fh->hashes = (uint64_t *)calloc(framecount, sizeof(uint64_t));
+  memset(&(fh->stats), 0, sizeof(framehashstats));
+  return fh;
+}
+
+void free_framehash(framehash *fh)
+{
+  if (fh)
+  {
+    free(fh->hashes);
+    free(fh);
+  }
+}
+
+void framehash_onload(framehash *fh, const uint16_t frame, const page *pg)
+{
+  fh->hashes[frame] = hash_page(pg);
+}
+
+bool framehash_unchanged(framehash *fh, const uint16_t frame, const page *pg)
+{
+  fh->stats.checked++;
+  if (hash_page(pg) != fh->hashes[frame])
+  {
+    return false;
+  }
+  fh->stats.elided++;
+  return true;
+}
+
+void print_framehashstats(const framehash *fh)
+{
+  const framehashstats *stats = &(fh->stats);
+  printf("silent store writebacks elided: %lu of %lu dirty pages (%.2f%%), bytes saved: %lu\n",
+         stats->elided,
+         stats->checked,
+         stats->checked ? 100.0 * stats->elided / stats->checked : 0.0,
+         stats->elided * PAGESIZE);
+}
@@ -5,12 +5,16 @@
 
 #include "pagetable.h"
 #include "memsimarg.h"
+#include "standby.h"
+#include "subpage.h"
+#include "framehash.h"
+#include "nextuse.h"
+#include "policy.h"
 
 typedef struct algonode
 {
   pagetableentry *pte_ref;
   uint16_t msb_virtualaddr; // base virtual addr with the offset zeroed out
-  uint16_t inmemoryoffset;
   double lastreferenced;
   struct algonode *next;
 } algonode;
@@ -19,7 +23,6 @@ void init_algonode(
     algonode **node,
     pagetableentry *pte,
     uint16_t msb_va,
-    uint16_t mem_offset,
     algonode *next);
 
 void free_algonode(algonode *node);
@@ -79,22 +82,691 @@ void free_lru(lru *);
 
 void update_referencedtime(lru *, uint16_t virtualaddr);
 
+/**
+ * Belady's optimal replacement, evicts the resident page whose next use is farthest away
+ * @trace: next-use index of the whole trace, built before the simulation starts
+ * @position: number of references seen so far
+ * @nextref: reference number of the next use of each page, as of @position
+ * @heap: resident pages as a binary max-heap on their next use
+ * @heapindex: slot of each page in @heap, -1 if the page is not resident
+ */
+typedef struct opt
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  nextuse *trace;
+  uint32_t position;
+  uint32_t nextref[PAGES];
+  algonode *heap[PAGES];
+  int heapindex[PAGES];
+} opt;
+
+opt *new_opt(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    const char *addrfile);
+
+void free_opt(opt *);
+
+void opt_onreference(opt *, uint16_t virtualaddr);
+
+/* ARC lists, resident T1 and T2 and their ghost lists B1 and B2 */
+#define ARC_T1 0
+#define ARC_T2 1
+#define ARC_B1 2
+#define ARC_B2 3
+#define ARC_LISTS 4
+#define ARC_NONE ARC_LISTS
+
+/* samples of the ARC target kept for the summary */
+#define ARC_PSAMPLES 16
+
+/**
+ * ARC statistics
+ * @misses: page faults seen by ARC
+ * @ghosthits: misses on a page of B1 and of B2, each one moves the target
+ * @pmin: lowest target reached
+ * @pmax: highest target reached
+ * @psamples: target sampled every @stride misses, evenly spaced over the run
+ * @nsamples: number of samples taken
+ * @stride: misses between two samples, doubled whenever @psamples fills up
+ */
+typedef struct arcstats
+{
+  unsigned long misses;
+  unsigned long ghosthits[2];
+  int pmin;
+  int pmax;
+  int psamples[ARC_PSAMPLES];
+  int nsamples;
+  unsigned long stride;
+} arcstats;
+
+/**
+ * Adaptive Replacement Cache
+ * T1 holds pages seen once recently, T2 pages seen at least twice, B1 and B2 remember pages
+ * evicted from T1 and T2 without their contents, a miss on them moves the target size of T1
+ * lists are doubly linked through page-indexed arrays, slot PAGES + list is the list's sentinel,
+ * its next is the MRU page and its prev the LRU page
+ * @p: target size of T1
+ * @pending: page about to be inserted into T2 after a ghost hit, -1 if none
+ * @pendingb2: true if @pending was a B2 ghost
+ * @prev: previous page on the same list, towards the MRU end
+ * @next: next page on the same list, towards the LRU end
+ * @size: number of pages on each list
+ * @where: list each page is on, ARC_NONE if it is on none
+ * @stats: ARC statistics
+ */
+typedef struct arc
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  int p;
+  int pending;
+  bool pendingb2;
+  int prev[PAGES + ARC_LISTS];
+  int next[PAGES + ARC_LISTS];
+  int size[ARC_LISTS];
+  uint8_t where[PAGES];
+  arcstats stats;
+} arc;
+
+arc *new_arc(
+    PAGETABLE type,
+    void *vpt,
+    int fcount);
+
+void free_arc(arc *);
+
+void arc_onmiss(arc *, uint16_t virtualaddr);
+
+void arc_onhit(arc *, uint16_t virtualaddr);
+
+void print_arcstats(const arc *);
+
+/* CLOCK-Pro page states */
+#define CLOCKPRO_NONE 0
+#define CLOCKPRO_HOT 1
+#define CLOCKPRO_COLD 2
+#define CLOCKPRO_NONRESIDENT 3
+
+/**
+ * CLOCK-Pro statistics
+ * @promotions: cold pages that turned hot, re-referenced within their test period
+ * @demotions: hot pages turned cold by the hot hand
+ * @testhits: faults on non-resident pages still in their test period, each one grows the cold target
+ * @testexpiries: test periods that ended without a re-reference, each one shrinks the cold target
+ * @coldmin: lowest cold target reached
+ * @coldmax: highest cold target reached
+ */
+typedef struct clockprostats
+{
+  unsigned long promotions;
+  unsigned long demotions;
+  unsigned long testhits;
+  unsigned long testexpiries;
+  int coldmin;
+  int coldmax;
+} clockprostats;
+
+/**
+ * CLOCK-Pro, a clock approximation of LIRS
+ * pages are hot or cold by their reuse distance, a cold page is on test for a while after it is
+ * brought in and turns hot if it is referenced again during its test, a non-resident cold page
+ * keeps its entry until the test ends so that a quick refault tells that memory for cold pages is short
+ * all pages sit on one circular list linked through page-indexed arrays, new pages are inserted
+ * right behind the hot hand, the hands move over it in the same direction and use the PTE referenced bits
+ * @coldtarget: target number of resident cold pages, adapted between 1 and maxsize - 1
+ * @handhot: demotes hot pages that were not referenced since it last passed, ends test periods it passes
+ * @handcold: evicts resident cold pages that were not referenced since it last passed
+ * @handtest: ends test periods, keeps the non-resident pages at no more than maxsize
+ * @hot: resident hot pages
+ * @cold: resident cold pages
+ * @nonresident: non-resident cold pages still on test
+ * @prev: previous page on the clock
+ * @next: next page on the clock, in the direction the hands move
+ * @state: CLOCKPRO_NONE, HOT, COLD or NONRESIDENT
+ * @test: true while a cold page is in its test period
+ * @stats: CLOCK-Pro statistics
+ */
+typedef struct clockpro
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  int coldtarget;
+  int handhot;
+  int handcold;
+  int handtest;
+  int hot;
+  int cold;
+  int nonresident;
+  int prev[PAGES];
+  int next[PAGES];
+  uint8_t state[PAGES];
+  bool test[PAGES];
+  clockprostats stats;
+} clockpro;
+
+clockpro *new_clockpro(
+    PAGETABLE type,
+    void *vpt,
+    int fcount);
+
+void free_clockpro(clockpro *);
+
+void print_clockprostats(const clockpro *);
+
+/**
+ * MGLRU statistics
+ * @agings: ticks that opened a new generation
+ * @promoted: pages moved to the youngest generation by aging, referenced since the previous tick
+ * @secondchances: pages referenced since the last tick found by eviction and moved to the youngest generation instead
+ * @folds: oldest generations folded into the next one to open a generation
+ * @evictions: pages evicted
+ * @evictedage: sum over evicted pages of the generations opened since theirs
+ */
+typedef struct mglrustats
+{
+  unsigned long agings;
+  unsigned long promoted;
+  unsigned long secondchances;
+  unsigned long folds;
+  unsigned long evictions;
+  unsigned long evictedage;
+} mglrustats;
+
+/**
+ * multi-generational LRU
+ * resident pages are kept in generations numbered by sequence, pages are faulted into the youngest one,
+ * every tick opens a new youngest generation and moves the pages referenced since the previous tick into it,
+ * eviction takes from the oldest generation
+ * each generation is a doubly linked list through page-indexed arrays, slot PAGES + seq % generations
+ * is the sentinel of generation seq, its next is the most recently added page and its prev the oldest one
+ * @generations: maximum number of generations, the oldest two are folded to open one more
+ * @minseq: sequence number of the oldest generation
+ * @maxseq: sequence number of the youngest generation
+ * @prev: previous page in the same generation, towards the most recently added one
+ * @next: next page in the same generation, towards the oldest one
+ * @size: number of pages in each generation slot
+ * @seq: generation of each resident page, -1 if the page is not resident
+ * @stats: MGLRU statistics
+ */
+typedef struct mglru
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  int generations;
+  unsigned long minseq;
+  unsigned long maxseq;
+  int prev[PAGES + MGLRU_MAX_GENERATIONS];
+  int next[PAGES + MGLRU_MAX_GENERATIONS];
+  int size[MGLRU_MAX_GENERATIONS];
+  long seq[PAGES];
+  mglrustats stats;
+} mglru;
+
+mglru *new_mglru(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int generations);
+
+void free_mglru(mglru *);
+
+void mglru_age(mglru *);
+
+void print_mglrustats(const mglru *);
+
+/**
+ * AGING statistics
+ * @ticks: ticks that shifted the counters
+ * @evictions: pages evicted
+ * @idleevictions: evicted pages whose counter was 0, not referenced for as many ticks as the counter has bits
+ */
+typedef struct agingstats
+{
+  unsigned long ticks;
+  unsigned long evictions;
+  unsigned long idleevictions;
+} agingstats;
+
+/**
+ * aging, NFU with shift registers
+ * every resident page has a counter of @bits bits, each tick shifts it right and puts the page's
+ * referenced bit in at the top, the page with the lowest counter is evicted, the oldest one on ties
+ * resident pages are packed into slots 0 .. currsize - 1 so that the tick runs over dense arrays,
+ * a binary min-heap of slots finds the victim without a scan
+ * @bits: width of the counters
+ * @stamp: insertions so far, orders pages with equal counters
+ * @age: counter of the page in each slot
+ * @referenced: referenced bit of the page in each slot, gathered from the page table at the tick
+ * @loaded: value of @stamp when the page in each slot was brought in
+ * @vpnof: page in each slot
+ * @slotof: slot of each resident page, -1 if the page is not resident
+ * @heap: slots as a binary min-heap on counter then @loaded
+ * @heapindex: position of each slot in @heap
+ * @stats: AGING statistics
+ */
+typedef struct aging
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  int bits;
+  uint32_t stamp;
+  uint32_t age[PAGES];
+  uint32_t referenced[PAGES];
+  uint32_t loaded[PAGES];
+  uint16_t vpnof[PAGES];
+  int slotof[PAGES];
+  int heap[PAGES];
+  int heapindex[PAGES];
+  agingstats stats;
+} aging;
+
+aging *new_aging(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int bits);
+
+void free_aging(aging *);
+
+void aging_tick(aging *);
+
+void print_agingstats(const aging *);
+
+/* samples of the working-set size kept for the summary */
+#define WSCLOCK_SAMPLES 32
+
+/**
+ * WSClock statistics
+ * @evictions: pages evicted
+ * @oldevictions: evicted pages that were out of the working set, the others were taken because none was
+ * @scheduled: writebacks of dirty pages out of the working set scheduled by the hand
+ * @wsmax: largest working set seen
+ * @wssum: sum of the working-set size over all references
+ * @wsover: references at which the working set did not fit in memory
+ * @wssamples: working-set size sampled every @stride references, evenly spaced over the run
+ * @nsamples: number of samples taken
+ * @stride: references between two samples, doubled whenever @wssamples fills up
+ */
+typedef struct wsclockstats
+{
+  unsigned long evictions;
+  unsigned long oldevictions;
+  unsigned long scheduled;
+  int wsmax;
+  unsigned long wssum;
+  unsigned long wsover;
+  int wssamples[WSCLOCK_SAMPLES];
+  int nsamples;
+  unsigned long stride;
+} wsclockstats;
+
+/**
+ * WSClock, working-set replacement with a clock hand
+ * virtual time is the number of references so far, the working set is the pages referenced in the
+ * last @tau of them, the hand evicts a clean page out of the working set and schedules the writeback
+ * of dirty ones, the next pass finds them clean
+ * resident pages sit on a circular list linked through page-indexed arrays
+ * @tau: working-set window in references
+ * @now: references so far, the virtual time
+ * @hand: page the hand points at, -1 if no page is resident
+ * @prev: previous page on the clock
+ * @next: next page on the clock, in the direction the hand moves
+ * @lastuse: virtual time right after the last reference to each page, 0 if it was never referenced
+ * @window: ring of the last @tau pages referenced
+ * @wssize: pages in the working set
+ * @cleanqueue: pages whose writeback the hand scheduled
+ * @ncleans: number of pages in @cleanqueue
+ * @queued: true if the page is in @cleanqueue
+ * @stats: WSClock statistics
+ */
+typedef struct wsclock
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  unsigned long tau;
+  unsigned long now;
+  int hand;
+  int prev[PAGES];
+  int next[PAGES];
+  unsigned long lastuse[PAGES];
+  uint16_t *window;
+  int wssize;
+  int cleanqueue[PAGES];
+  int ncleans;
+  bool queued[PAGES];
+  wsclockstats stats;
+} wsclock;
+
+wsclock *new_wsclock(
+    PAGETABLE type,
+    void *vpt,
+    int fcount,
+    int tau);
+
+void free_wsclock(wsclock *);
+
+void wsclock_onreference(wsclock *, uint16_t virtualaddr);
+
+void print_wsclockstats(const wsclock *);
+
+/**
+ * LFU statistics
+ * @evictions: pages evicted
+ * @evictedcount: sum of the counts of the evicted pages
+ * @coldevictions: evicted pages whose count had decayed to 0
+ * @decays: ticks that halved every count
+ * @maxbuckets: most frequency buckets in use at once
+ */
+typedef struct lfustats
+{
+  unsigned long evictions;
+  unsigned long evictedcount;
+  unsigned long coldevictions;
+  unsigned long decays;
+  int maxbuckets;
+} lfustats;
+
+/**
+ * O(1) LFU, resident pages grouped into buckets of equal reference count
+ * the buckets form a doubly linked list in increasing count order, each bucket holds a doubly linked list
+ * of its pages, oldest first, a fault or a hit moves a page one bucket up and eviction takes the oldest
+ * page of the lowest bucket, all in constant time
+ * every tick halves the counts, merging buckets that end up with the same count
+ * buckets come from a pool allocated with the replacer, there is never more of them than resident pages
+ * @lowest: bucket with the lowest count, -1 if no page is resident
+ * @freebuckets: first unused bucket, the unused ones are chained through @higher
+ * @nbuckets: buckets in use
+ * @count: reference count of the pages in each bucket
+ * @first: oldest page of each bucket
+ * @last: newest page of each bucket
+ * @lower: bucket with the next lower count, -1 if none
+ * @higher: bucket with the next higher count, -1 if none
+ * @bucketof: bucket of each page, -1 if the page is not resident
+ * @prev: previous page in the same bucket, -1 if none
+ * @next: next page in the same bucket, -1 if none
+ * @stats: LFU statistics
+ */
+typedef struct lfu
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  int lowest;
+  int freebuckets;
+  int nbuckets;
+  uint32_t count[PAGES];
+  int first[PAGES];
+  int last[PAGES];
+  int lower[PAGES];
+  int higher[PAGES];
+  int bucketof[PAGES];
+  int prev[PAGES];
+  int next[PAGES];
+  lfustats stats;
+} lfu;
+
+lfu *new_lfu(
+    PAGETABLE type,
+    void *vpt,
+    int fcount);
+
+void free_lfu(lfu *);
+
+void lfu_onhit(lfu *, uint16_t virtualaddr);
+
+void lfu_decay(lfu *);
+
+void print_lfustats(const lfu *);
+
+/* one page in ADAPTIVE_SAMPLE_RATIO is followed by the shadow policies, a power of 2 */
+#define ADAPTIVE_SAMPLE_RATIO 8
+/* fewest frames of a shadow, LRU, MRU and LFU pick the same victim out of a single frame */
+#define ADAPTIVE_MIN_SHADOW 4
+/* sampled references per epoch, the shadow miss counts are compared at the end of each */
+#define ADAPTIVE_EPOCH 256
+/* percent fewer shadow misses a policy needs over the live one to take over */
+#define ADAPTIVE_MARGIN 10
+/* policy switches kept for the summary */
+#define ADAPTIVE_LOG 32
+
+/**
+ * policies ADAPTIVE chooses from
+ * LRU for recency, MRU for loops larger than memory, LFU for skewed frequencies
+ */
+typedef enum ADAPTIVEPOLICY
+{
+  ADAPTIVE_LRU,
+  ADAPTIVE_MRU,
+  ADAPTIVE_LFU
+} ADAPTIVEPOLICY;
+
+#define ADAPTIVE_POLICIES 3
+
+/**
+ * recency order of a set of pages, linked through page-indexed arrays
+ * @head: most recently used page, -1 if the list is empty
+ * @tail: least recently used page, -1 if the list is empty
+ * @size: pages on the list
+ * @prev: next more recently used page, -1 if none
+ * @next: next less recently used page, -1 if none
+ * @member: true if the page is on the list
+ */
+typedef struct recencylist
+{
+  int head;
+  int tail;
+  int size;
+  int prev[PAGES];
+  int next[PAGES];
+  bool member[PAGES];
+} recencylist;
+
+/**
+ * switch of the live ADAPTIVE policy
+ * @reference: references seen when the policy switched
+ * @from: policy evicting before
+ * @to: policy evicting from then on
+ */
+typedef struct adaptiveswitch
+{
+  unsigned long reference;
+  ADAPTIVEPOLICY from;
+  ADAPTIVEPOLICY to;
+} adaptiveswitch;
+
+/**
+ * ADAPTIVE statistics
+ * @sampledreferences: references to sampled pages, seen by the shadows
+ * @shadowmisses: misses of each shadow policy
+ * @evictions: pages evicted while each policy was live
+ * @epochs: epochs ended
+ * @switches: switches of the live policy
+ * @log: the first ADAPTIVE_LOG switches
+ */
+typedef struct adaptivestats
+{
+  unsigned long sampledreferences;
+  unsigned long shadowmisses[ADAPTIVE_POLICIES];
+  unsigned long evictions[ADAPTIVE_POLICIES];
+  unsigned long epochs;
+  unsigned long switches;
+  adaptiveswitch log[ADAPTIVE_LOG];
+} adaptivestats;
+
+/**
+ * adaptive replacement by set dueling
+ * every candidate policy runs as a shadow over the references to a sample of the pages,
+ * with memory scaled down to match, the live policy switches to the shadow with the fewest misses
+ * once it beats the live one by ADAPTIVE_MARGIN percent, miss counts are halved every epoch
+ * so that the choice follows the phases of the trace
+ * the resident pages are kept in recency and frequency order at once, a switch takes effect
+ * at the next eviction
+ * @live: policy picking the victims
+ * @now: references so far
+ * @recency: recency order of the resident pages, for LRU and MRU
+ * @frequency: frequency buckets of the resident pages, for LFU
+ * @sampleratio: one page in this many is sampled, ADAPTIVE_SAMPLE_RATIO unless that leaves the shadows
+ *               fewer than ADAPTIVE_MIN_SHADOW frames, halved until it does not
+ * @sampled: true if the shadows follow the page
+ * @nsampled: number of sampled pages
+ * @shadowsize: frames of each shadow
+ * @shadowlru: pages the LRU shadow holds
+ * @shadowmru: pages the MRU shadow holds
+ * @shadowlfu: pages the LFU shadow holds
+ * @epochreferences: sampled references in the current epoch
+ * @epochmisses: shadow misses in the current epoch
+ * @score: shadow misses, halved at the end of every epoch
+ * @stats: ADAPTIVE statistics
+ */
+typedef struct adaptive
+{
+  PAGETABLE type;
+  void *vpt;
+  int currsize;
+  int maxsize;
+  ADAPTIVEPOLICY live;
+  unsigned long now;
+  recencylist recency;
+  lfu *frequency;
+  int sampleratio;
+  bool sampled[PAGES];
+  int nsampled;
+  int shadowsize;
+  recencylist shadowlru;
+  recencylist shadowmru;
+  lfu *shadowlfu;
+  int epochreferences;
+  unsigned long epochmisses[ADAPTIVE_POLICIES];
+  unsigned long score[ADAPTIVE_POLICIES];
+  adaptivestats stats;
+} adaptive;
+
+adaptive *new_adaptive(
+    PAGETABLE type,
+    void *vpt,
+    int fcount);
+
+void free_adaptive(adaptive *);
+
+void adaptive_onreference(adaptive *, uint16_t virtualaddr);
+
+void adaptive_onhit(adaptive *, uint16_t virtualaddr);
+
+void adaptive_tick(adaptive *);
+
+void print_adaptivestats(const adaptive *);
+
+/**
+ * in-memory frame allocator
+ * frames are handed out lowest first, a frame is free again once no page is mapped to it
+ * @framecount: number of in-memory frames
+ * @sharers: number of pages mapped to each frame, more than one once identical pages are merged
+ * @firstpage: one of the pages mapped to each frame, -1 if the frame is free
+ * @nextpage: next page mapped to the same frame, -1 if none
+ * @freeframes: stack of free frames
+ * @nfree: number of free frames
+ * @heldframes: stack of frames held back, neither free nor in use, while fewer frames are allotted than there are
+ * @nheld: number of frames held back
+ * @sb: standby list kept on the free frames, NULL if disabled
+ */
+typedef struct framepool
+{
+  int framecount;
+  int *sharers;
+  int *firstpage;
+  int nextpage[PAGES];
+  int *freeframes;
+  int nfree;
+  int *heldframes;
+  int nheld;
+  standby *sb;
+} framepool;
+
+framepool *new_framepool(int framecount, standby *sb);
+
+void free_framepool(framepool *);
+
+uint16_t acquire_frame(framepool *);
+
+uint16_t claim_frame(framepool *, const uint16_t frame);
+
+void map_frame(framepool *, const uint16_t frame, const uint16_t vpn);
+
+bool unmap_frame(framepool *, const uint16_t frame, const uint16_t vpn);
+
+void hold_frame(framepool *);
+
+void release_frame(framepool *);
+
+/**
+ * outcome of making room in memory
+ * @evictions: pages evicted until enough frames were free
+ * @evictedVA: base virtual address of the last evicted page, valid if @evictions is not 0
+ */
+struct reclaimresult
+{
+  int evictions;
+  uint16_t evictedVA;
+};
+
+struct reclaimresult reclaimframes(
+    replacer *pagereplacer,
+    page *memory,
+    framepool *frames,
+    swapspace *ss,
+    standby *sb,
+    subpage *sp,
+    framehash *fh,
+    const int target);
+
+/**
+ * page fault outcome
+ * @VA: faulting virtual address
+ * @PFN: frame the page was loaded into
+ * @evictions: resident pages that had to be evicted to make room, 0 if a frame was free
+ * @evictedVA: base virtual address of the last evicted page, valid if @evictions is not 0
+ * @zerofilled: true if the page was never written to swap and the frame was zero filled without a swap read
+ * @fromstandby: true if the page was still on the standby list, a soft fault without I/O
+ */
 struct pagefaultresult
 {
   uint16_t VA;
   uint16_t PFN;
+  int evictions;
+  uint16_t evictedVA;
+  bool zerofilled;
+  bool fromstandby;
 };
 
 /**
  * PAGE FAULT HANDLER
  */
 struct pagefaultresult handlepagefault(
-    ALGO algo,
-    void *pagereplacer,
+    replacer *pagereplacer,
     uint16_t virtualaddr,
     page *memory,
-    int *currmemorysize,
+    framepool *frames,
     swapspace *ss,
+    standby *sb,
+    subpage *sp,
+    framehash *fh,
     bool ismodified,
     uint8_t writevalue);
 
@@ -0,0 +1,38 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/**
+ * Page compressor, a small byte oriented LZ77 variant
+ * the compressed stream is a sequence of tokens, each starting with a control byte
+ * 0xxxxxxx: literal run of x + 1 bytes, the bytes follow
+ * 1xxxxxxx: match of x + COMPRESS_MIN_MATCH bytes, a one byte distance (1..255) follows
+ * matches may overlap their own output, so runs of a repeated byte compress to one token
+ */
+
+/* shortest match worth a token */
+#define COMPRESS_MIN_MATCH 3
+
+/* longest match a single token can encode */
+#define COMPRESS_MAX_MATCH (0x7f + COMPRESS_MIN_MATCH)
+
+/* longest literal run a single token can encode */
+#define COMPRESS_MAX_LITERALS 0x80
+
+/* furthest back a match may reach */
+#define COMPRESS_MAX_DISTANCE 0xff
+
+/* worst case compressed size of a page, every byte a literal */
+#define COMPRESS_BOUND (PAGESIZE + (PAGESIZE + COMPRESS_MAX_LITERALS - 1) / COMPRESS_MAX_LITERALS)
+
+int compress_page(const page *, uint8_t *out);
+
+bool decompress_page(const uint8_t *in, const int size, page *);
+
+bool is_samefilled(const page *, uint8_t *value);
+
+#endif
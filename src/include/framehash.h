@@ -0,0 +1,47 @@
+#ifndef FRAMEHASH_H
+#define FRAMEHASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/**
+ * silent store elision statistics
+ * @checked: dirty frames compared against their hash at eviction or shutdown
+ * @elided: dirty frames whose contents were unchanged, their writeback was skipped
+ */
+typedef struct framehashstats
+{
+  unsigned long checked;
+  unsigned long elided;
+} framehashstats;
+
+/**
+ * content hash of every frame taken when its page was loaded
+ * writes of the value already in place still mark a page modified,
+ * a dirty frame that hashes the same as when it was loaded needs no writeback
+ * @framecount: number of frames tracked
+ * @hashes: hash of each frame's contents at page-in
+ * @stats: silent store elision statistics
+ */
+typedef struct framehash
+{
+  int framecount;
+  uint64_t *hashes;
+  framehashstats stats;
+} framehash;
+
+uint64_t hash_page(const page *);
+
+framehash *new_framehash(int framecount);
+
+void free_framehash(framehash *);
+
+void framehash_onload(framehash *, const uint16_t frame, const page *);
+
+bool framehash_unchanged(framehash *, const uint16_t frame, const page *);
+
+void print_framehashstats(const framehash *);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef KSM_H
+#define KSM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+#include "pagetable.h"
+#include "algorithmsk.h"
+
+/**
+ * same-page merging statistics
+ * @scanned: frames looked at by the scanner
+ * @merged: pages moved onto a frame with identical contents, each one freeing a frame
+ * @cowbreaks: writes to a merged page that gave the page a private copy first
+ * @samples: scans the gained frames were sampled at
+ * @gainedtotal: sum of the frames gained over all samples
+ * @gainedpeak: most frames gained at once
+ */
+typedef struct ksmstats
+{
+  unsigned long scanned;
+  unsigned long merged;
+  unsigned long cowbreaks;
+  unsigned long samples;
+  unsigned long gainedtotal;
+  int gainedpeak;
+} ksmstats;
+
+/**
+ * same-page merging scanner
+ * clean frames are hashed round robin, a frame whose contents match another clean frame
+ * has its page remapped onto that frame and goes back to the free frames,
+ * a merged frame is read only and a write to one of its pages copies it first
+ * @pagestoscan: frames looked at per scan
+ * @cursor: next frame to scan
+ * @hashes: contents hash of each frame when it was last scanned
+ * @hashed: true if the frame was clean and unmerged when it was last scanned
+ * @stats: same-page merging statistics
+ */
+typedef struct ksm
+{
+  int pagestoscan;
+  int cursor;
+  uint64_t *hashes;
+  bool *hashed;
+  ksmstats stats;
+} ksm;
+
+ksm *new_ksm(int pagestoscan, int framecount);
+
+void free_ksm(ksm *);
+
+void ksm_scan(ksm *, framepool *, page *memory, const uint64_t *dirtyframes, PAGETABLE type, void *vpt);
+
+void print_ksmstats(const ksm *, const framepool *);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef KSWAPD_H
+#define KSWAPD_H
+
+#include <stdbool.h>
+
+/**
+ * reclaim statistics
+ * @faults: page faults that needed a frame
+ * @directfaults: faults that found no free frame and evicted themselves
+ * @directevictions: pages evicted by faulting references
+ * @wakeups: background reclaim runs, one each time free frames dropped below the low watermark
+ * @backgroundevictions: pages evicted by background reclaim
+ */
+typedef struct kswapdstats
+{
+  unsigned long faults;
+  unsigned long directfaults;
+  unsigned long directevictions;
+  unsigned long wakeups;
+  unsigned long backgroundevictions;
+} kswapdstats;
+
+/**
+ * background reclaim, keeps free frames around so that faults rarely evict themselves
+ * once free frames drop below @low, pages picked by the page replacer are evicted
+ * in one batch until @high frames are free
+ * @low: free frames below which background reclaim wakes up
+ * @high: free frames background reclaim stops at
+ * @stats: reclaim statistics
+ */
+typedef struct kswapd
+{
+  int low;
+  int high;
+  kswapdstats stats;
+} kswapd;
+
+kswapd *new_kswapd(int low, int high);
+
+void free_kswapd(kswapd *);
+
+bool kswapd_shouldwake(const kswapd *, const int nfree);
+
+void kswapd_onfault(kswapd *, const int evictions);
+
+void kswapd_onreclaim(kswapd *, const int evictions);
+
+void print_kswapdstats(const kswapd *);
+
+#endif
@@ -11,11 +11,103 @@ typedef enum ALGO
   FIFO,
   LRU,
   CLOCK,
-  ECLOCK
+  ECLOCK,
+  OPT,
+  ARC,
+  CLOCKPRO,
+  MGLRU,
+  AGING,
+  WSCLOCK,
+  LFU,
+  ADAPTIVE,
+  PLUGIN
 } ALGO;
 
 #define INVALID_ALGO -1
 
+/* generations MGLRU can keep, and the default */
+#define MGLRU_MIN_GENERATIONS 2
+#define MGLRU_MAX_GENERATIONS 16
+#define MGLRU_DEFAULT_GENERATIONS 4
+
+/* width of the AGING counters in bits, and the default */
+#define AGING_MIN_BITS 8
+#define AGING_MAX_BITS 32
+#define AGING_DEFAULT_BITS 8
+
+/* WSCLOCK working-set window in references, and the default */
+#define WSCLOCK_MAX_TAU (1 << 24)
+#define WSCLOCK_DEFAULT_TAU 1000
+
+/* PFF fault rate window in references, and the default */
+#define PFF_MAX_WINDOW (1 << 24)
+#define PFF_DEFAULT_WINDOW 1000
+
+/**
+ * Swapspace durability mode, controls how often the swap file is msync'ed
+ * NONE: never sync, the kernel writes the mapping back whenever it likes
+ * END: sync once when the simulator shuts down
+ * PERIODIC: sync every <period> memory references and at shutdown
+ * EVERY_EVICT: sync every page written back on eviction and at shutdown
+ */
+typedef enum DURABILITY
+{
+  DURABILITY_NONE,
+  DURABILITY_END,
+  DURABILITY_PERIODIC,
+  DURABILITY_EVERY_EVICT
+} DURABILITY;
+
+#define INVALID_DURABILITY -1
+
+/**
+ * Swap I/O backend
+ * MMAP: shared mapping of the swap file, the page cache absorbs all traffic
+ * PREAD: buffered pread/pwrite system calls
+ * DIRECT: O_DIRECT pread/pwrite through block aligned bounce buffers
+ * URING: io_uring submissions through raw system calls
+ */
+typedef enum SWAPIO
+{
+  SWAPIO_MMAP,
+  SWAPIO_PREAD,
+  SWAPIO_DIRECT,
+  SWAPIO_URING
+} SWAPIO;
+
+#define INVALID_SWAPIO -1
+
+/**
+ * Swap layout, where a page lives in the swap file
+ * FIXED: page n always lives in slot n
+ * LOG: evicted pages are appended to a log of segments, a remap table tracks their slots
+ * COMPACT: a page gets a slot when it is first written to swap, the file grows on demand
+ */
+typedef enum SWAPLAYOUT
+{
+  SWAPLAYOUT_FIXED,
+  SWAPLAYOUT_LOG,
+  SWAPLAYOUT_COMPACT
+} SWAPLAYOUT;
+
+#define INVALID_SWAPLAYOUT -1
+
+/* swap devices a simulator can use, the -s swapfile included */
+#define MAX_SWAPDEVICES 8
+
+/**
+ * additional swap device
+ * @path: name/path of the device's swap file
+ * @priority: devices with a higher priority fill up first, equal priorities are striped
+ * @slots: number of pages the device can hold
+ */
+typedef struct swapdevarg
+{
+  char *path;
+  int priority;
+  int slots;
+} swapdevarg;
+
 /**
  * Simulator Command-line args
  * @level: number of levels in page table. 1 or 2
@@ -23,8 +115,33 @@ typedef enum ALGO
  * @swapfile: name/path of binary file storing pages
  * @fcount: number of frames to be used by the simulated program
  * @algo: page replacement algorithm option
+ * @pluginpath: policy module given as -a plugin:<path>, NULL for built-in algorithms
  * @tick: timer tick period
  * @outfile: name/path of the output file generated by simulator
+ * @writeback: --writeback=<depth>, background writeback queue depth, 0 writes dirty pages synchronously
+ * @durability: --durability=none|end|periodic:N|every-evict, swap file sync mode
+ * @syncperiod: number of memory references between syncs in periodic mode
+ * @swapio: --swapio=mmap|pread|direct|uring, swap I/O backend
+ * @readahead: --readahead=<pages>, maximum read-ahead window, 0 disables read-ahead
+ * @markovdegree: --markov=<degree>[:<entries>], successors prefetched per fault, 0 disables it
+ * @markovtablesize: number of pages tracked by the correlation table
+ * @zswap: --zswap=<bytes>, compressed pool budget in front of the swap file, 0 disables the pool
+ * @standby: --standby=<frames>, frames of -f kept free so recently evicted pages can be reclaimed from them, 0 disables the standby list
+ * @swaplayout: --swaplayout=fixed|log|compact, swap file layout
+ * @swapdevs: --swapdev=<priority>:<slots>:<path>, swap devices next to the swapfile, which has priority 0
+ * @swapdevcount: number of additional swap devices
+ * @dirtygranularity: --dirtygran=byte|word|line, bytes per sub-page dirty bit, 0 writes dirty pages back whole
+ * @elidesilent: --elidesilent, skip the writeback of dirty pages whose contents did not change
+ * @ksm: --ksm=<pages>, frames the same-page merging scanner looks at every tick, 0 disables merging
+ * @lowwatermark: --watermarks=<low>:<high>, free frames below which background reclaim starts, 0 disables it
+ * @highwatermark: free frames background reclaim stops at
+ * @generations: --generations=<n>, generations kept by MGLRU
+ * @agebits: --agebits=<n>, width of the AGING counters
+ * @tau: --tau=<references>, working-set window of WSCLOCK in references
+ * @pfflow: --pff=<low>:<high>, fault rate in percent below which PFF takes frames away, PFF is off unless @pffhigh is set
+ * @pffhigh: fault rate in percent above which PFF adds frames, 0 allots -f frames for the whole run
+ * @pffwindow: --pffwindow=<references>, references the PFF fault rate is measured over
+ * @pffmin: --pffmin=<frames>, fewest frames PFF allots, -f is the most
  */
 typedef struct cmd_args
 {
@@ -33,8 +150,33 @@ typedef struct cmd_args
   char *swapfile;
   int fcount;
   ALGO algo;
+  char *pluginpath;
   int tick;
   char *outfile;
+  int writeback;
+  DURABILITY durability;
+  int syncperiod;
+  SWAPIO swapio;
+  int readahead;
+  int markovdegree;
+  int markovtablesize;
+  int zswap;
+  int standby;
+  SWAPLAYOUT swaplayout;
+  swapdevarg swapdevs[MAX_SWAPDEVICES - 1];
+  int swapdevcount;
+  int dirtygranularity;
+  bool elidesilent;
+  int ksm;
+  int lowwatermark;
+  int highwatermark;
+  int generations;
+  int agebits;
+  int tau;
+  double pfflow;
+  double pffhigh;
+  int pffwindow;
+  int pffmin;
 } cmd_args;
 
 cmd_args *new_cmdargs(void);
@@ -43,6 +185,8 @@ void free_cmdargs(cmd_args *);
 
 void print_cmdargs(const cmd_args *);
 
+void get_algo_str(ALGO algo, char **algo_str);
+
 bool init_cmdargs(cmd_args *, const int argc, const char *argv[]);
 
 #endif
\ No newline at end of file
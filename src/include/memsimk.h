@@ -7,21 +7,64 @@
 #include "swapspace.h"
 #include "pagetable.h"
 #include "algorithmsk.h"
+#include "prefetch.h"
+#include "ksm.h"
+#include "kswapd.h"
+#include "pff.h"
 
+// per-frame bitmaps, one bit per in-memory frame
+#define FRAME_BITMAP_WORDS(fcount) (((fcount) + 63) / 64)
+#define SET_FRAME_BIT(bitmap, frame) bitmap[(frame) >> 6] |= (uint64_t)1 << ((frame) & 63)
+#define UNSET_FRAME_BIT(bitmap, frame) bitmap[(frame) >> 6] &= ~((uint64_t)1 << ((frame) & 63))
+
+/**
+ * Simulator state
+ * @pagereplacer: page replacement policy, built in or loaded from a policy module
+ * @references: memory references of the trace
+ * @pagefaults: demand page faults, zero-fill faults included
+ * @zerofillfaults: demand faults on never written pages, resolved without a swap read
+ * @zerofills: pages zero filled instead of read from swap, prefetched pages included
+ * @standbyfaults: demand faults resolved from the standby list without I/O
+ * @frames: frame allocator, also tracks the pages held by each frame
+ * @dirtyframes: bitmap of frames whose page is modified but not yet written back
+ * @syncperiod: number of memory references between syncs in periodic durability mode
+ * @shutdownflushed: number of dirty frames written back when the trace ended
+ * @pf: page prefetcher, NULL if prefetching is disabled
+ * @sb: standby list of recently evicted pages, NULL if disabled
+ * @sp: sub-page dirty tracking, NULL if dirty pages are written back whole
+ * @fh: frame hashes taken at page-in to elide writebacks after silent stores, NULL if disabled
+ * @ksm: same-page merging scanner, NULL if disabled
+ * @kswapd: background reclaim, NULL if faults evict pages themselves
+ * @pff: page-fault-frequency frame allocation, NULL if all frames are allotted for the whole run
+ */
 typedef struct memsim
 {
-  ALGO pagereplaceralgo;
-  void *pagereplacer;
+  replacer *pagereplacer;
   PAGETABLE type;
   void *vpt;
   swapspace *ss;
   page *memory;
-  int currmemorysize;
   int framecount;
   FILE *outfile;
+  int references;
+  int pagefaults;
+  int zerofillfaults;
+  int zerofills;
+  int standbyfaults;
+  framepool *frames;
+  uint64_t *dirtyframes;
+  int syncperiod;
+  int shutdownflushed;
+  prefetcher *pf;
+  standby *sb;
+  subpage *sp;
+  framehash *fh;
+  ksm *ksm;
+  kswapd *kswapd;
+  pff *pff;
 } memsim;
 
-memsim *new_memsim(int level, int fcount, char *swapfile, char *outfile, ALGO algo);
+memsim *new_memsim(const cmd_args *);
 
 void free_memsim(memsim *);
 
@@ -29,4 +72,8 @@ void read_source(memsim *, const char *inputfile, const int tick);
 
 void reset_references(memsim *);
 
+int flush_dirtyframes(memsim *);
+
+void print_summary(memsim *);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef NEXTUSE_H
+#define NEXTUSE_H
+
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/* next use of a page that is never referenced again */
+#define NEXTUSE_NEVER UINT32_MAX
+
+/**
+ * next-use index of a trace, built by one backward pass before the simulation starts
+ * references are numbered in trace order from 0
+ * @count: memory references in the trace
+ * @next: reference number of the next reference to the same page, NEXTUSE_NEVER if there is none
+ * @first: reference number of the first reference to each page, NEXTUSE_NEVER if it is never referenced
+ */
+typedef struct nextuse
+{
+  uint32_t count;
+  uint32_t *next;
+  uint32_t first[PAGES];
+} nextuse;
+
+nextuse *new_nextuse(const char *addrfile);
+
+void free_nextuse(nextuse *);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PFF_H
+#define PFF_H
+
+#include <stdbool.h>
+
+/* windows sampled for the summary */
+#define PFF_SAMPLES 32
+
+/**
+ * page-fault-frequency statistics
+ * @grows: windows that ended with more frames allotted
+ * @shrinks: windows that ended with fewer frames allotted
+ * @framesum: sum of the frames allotted over all references
+ * @maxallotted: most frames allotted at once
+ * @frames: frames allotted during a window, sampled every @stride windows, evenly spaced over the run
+ * @rates: fault rate in percent of the sampled windows
+ * @nsamples: number of samples taken
+ * @stride: windows between two samples, doubled whenever the samples fill up
+ */
+typedef struct pffstats
+{
+  unsigned long grows;
+  unsigned long shrinks;
+  unsigned long framesum;
+  int maxallotted;
+  int frames[PFF_SAMPLES];
+  double rates[PFF_SAMPLES];
+  int nsamples;
+  unsigned long stride;
+} pffstats;
+
+/**
+ * page-fault-frequency frame allocation, the frames a trace gets follow its fault rate
+ * the fault rate is measured over windows of @window references, at the end of a window
+ * a rate above @high grows the allotment by a quarter, a rate below @low shrinks it by an eighth,
+ * by one frame at least, within @minframes and @maxframes
+ * the allotment starts at @minframes
+ * @window: references per window
+ * @low: fault rate in percent below which frames are taken away
+ * @high: fault rate in percent above which frames are added
+ * @minframes: fewest frames ever allotted
+ * @maxframes: most frames ever allotted
+ * @allotted: frames allotted right now
+ * @references: references in the current window
+ * @windowstart: page faults before the current window
+ * @windows: windows ended so far
+ * @stats: page-fault-frequency statistics
+ */
+typedef struct pff
+{
+  int window;
+  double low;
+  double high;
+  int minframes;
+  int maxframes;
+  int allotted;
+  int references;
+  int windowstart;
+  unsigned long windows;
+  pffstats stats;
+} pff;
+
+pff *new_pff(int window, double low, double high, int minframes, int maxframes);
+
+void free_pff(pff *);
+
+int pff_onreference(pff *, const int pagefaults);
+
+void print_pffstats(const pff *);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include <stdint.h>
+
+#include "memsimarg.h"
+#include "pagetable.h"
+
+/* symbol a policy module exports its replacementpolicy under */
+#define POLICY_SYMBOL "memsim_policy"
+
+/**
+ * page replacement policy, the simulator reaches every policy, built in or loaded from a module, through one
+ * every hook gets the state create returned, hooks marked optional may be NULL
+ * @name: name of the policy in the summary
+ * @create: sets the policy up for the page table vpt with fcount frames, args carries the policy options,
+ *          up to PAGES pages can be resident at once when frames are shared
+ * @destroy: releases everything create acquired, optional
+ * @on_reference: every reference before it is resolved, optional
+ * @on_hit: reference to a resident page, optional
+ * @on_fault: page about to be brought in by a fault or by prefetching, before room is made for it, optional
+ * @choose_victim: picks the page to evict and forgets it, returns its base virtual address, -1 if there is none
+ * @on_load: page brought into a frame by a fault or by prefetching, its page table entry is set up already
+ * @on_evict: page picked by choose_victim, written back and gone from memory, optional
+ * @on_tick: timer tick, before the referenced bits of the tick that just ended are reset, optional
+ * @writebacks: hands over the pages whose writeback choose_victim scheduled instead of evicting them,
+ *              copies their base virtual addresses to pages and returns how many there are, optional
+ * @print_stats: prints the policy statistics at the end of the summary, optional
+ */
+typedef struct replacementpolicy
+{
+  const char *name;
+  void *(*create)(PAGETABLE type, void *vpt, int fcount, const cmd_args *args);
+  void (*destroy)(void *state);
+  void (*on_reference)(void *state, uint16_t virtualaddr);
+  void (*on_hit)(void *state, uint16_t virtualaddr);
+  void (*on_fault)(void *state, uint16_t virtualaddr);
+  int (*choose_victim)(void *state);
+  void (*on_load)(void *state, uint16_t virtualaddr, pagetableentry *pte);
+  void (*on_evict)(void *state, uint16_t virtualaddr);
+  void (*on_tick)(void *state);
+  int (*writebacks)(void *state, uint16_t *pages);
+  void (*print_stats)(const void *state);
+} replacementpolicy;
+
+/**
+ * page replacer, a policy and its state
+ * @policy: hooks of the policy
+ * @state: what the create hook returned
+ * @type: page table type
+ * @vpt: page table the policy works on
+ * @module: handle of the policy module, NULL for built-in policies
+ */
+typedef struct replacer
+{
+  const replacementpolicy *policy;
+  void *state;
+  PAGETABLE type;
+  void *vpt;
+  void *module;
+} replacer;
+
+const replacementpolicy *get_policy(ALGO);
+
+replacer *new_replacer(const cmd_args *, PAGETABLE type, void *vpt);
+
+void free_replacer(replacer *);
+
+void replacer_onreference(replacer *, uint16_t virtualaddr);
+
+void replacer_onhit(replacer *, uint16_t virtualaddr);
+
+void replacer_onfault(replacer *, uint16_t virtualaddr);
+
+int replacer_choosevictim(replacer *);
+
+void replacer_onload(replacer *, uint16_t virtualaddr, pagetableentry *pte);
+
+void replacer_onevict(replacer *, uint16_t virtualaddr);
+
+void replacer_ontick(replacer *);
+
+int replacer_writebacks(replacer *, uint16_t *pages);
+
+void print_replacerstats(const replacer *);
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/* initial read-ahead window in pages */
+#define READAHEAD_INITIAL_WINDOW 2
+
+/* successors remembered per page by the correlation prefetcher */
+#define MARKOV_SUCCESSORS 4
+
+/* default number of pages tracked by the correlation prefetcher */
+#define MARKOV_DEFAULT_TABLESIZE 256
+
+/* successor counts are halved once one of them reaches this value */
+#define MARKOV_MAX_COUNT 255
+
+/**
+ * Prefetch engine a page was brought in by
+ */
+typedef enum PREFETCHSOURCE
+{
+  PREFETCH_NONE,
+  PREFETCH_READAHEAD,
+  PREFETCH_MARKOV,
+  PREFETCH_SOURCES
+} PREFETCHSOURCE;
+
+typedef struct prefetchcandidate
+{
+  uint16_t vpn;
+  PREFETCHSOURCE source;
+} prefetchcandidate;
+
+/**
+ * sequential and strided read-ahead
+ * a stream is detected once two consecutive accesses advance by the same stride,
+ * the window doubles every time a prefetched page is used and halves when one
+ * is evicted without ever being referenced
+ * @maxwindow: upper bound of the window in pages
+ * @window: number of pages prefetched ahead of the stream
+ * @lastvpn: last page that fed the detector, -1 before the first access
+ * @stride: distance in pages between the last two accesses
+ * @streak: number of consecutive accesses that advanced by @stride
+ * @frontier: furthest page already prefetched for the current stream, -1 if none
+ */
+typedef struct readahead
+{
+  int maxwindow;
+  int window;
+  int lastvpn;
+  int stride;
+  int streak;
+  int frontier;
+} readahead;
+
+/**
+ * correlation table entry
+ * @vpn: page the entry belongs to, -1 if the entry is free
+ * @successors: pages that faulted right after @vpn
+ * @counts: number of times each successor was observed, 0 marks a free slot
+ */
+typedef struct markoventry
+{
+  int vpn;
+  uint16_t successors[MARKOV_SUCCESSORS];
+  uint8_t counts[MARKOV_SUCCESSORS];
+} markoventry;
+
+/**
+ * markov (correlation) prefetcher for repeating but irregular fault streams
+ * @degree: maximum number of successors prefetched per access
+ * @tablesize: number of entries in @table
+ * @table: bounded correlation table, entries are recycled round robin
+ * @entryof: table index of each page, -1 if the page is not tracked
+ * @nextvictim: next entry to recycle once the table is full
+ * @lastvpn: previous page of the fault stream, -1 before the first access
+ * @lookups: accesses the table was consulted for
+ * @predictions: lookups that found at least one successor
+ */
+typedef struct markov
+{
+  int degree;
+  int tablesize;
+  markoventry *table;
+  int entryof[PAGES];
+  int nextvictim;
+  int lastvpn;
+  unsigned long lookups;
+  unsigned long predictions;
+} markov;
+
+/**
+ * prefetch statistics
+ * @issued: pages brought in ahead of a demand access
+ * @used: prefetched pages later referenced while still resident, each one a demand fault avoided
+ * @wasted: prefetched pages evicted without ever being referenced
+ * @unused: prefetched pages still unreferenced when the trace ended
+ */
+typedef struct prefetchstats
+{
+  unsigned long issued;
+  unsigned long used;
+  unsigned long wasted;
+  unsigned long unused;
+} prefetchstats;
+
+/**
+ * page prefetcher, owns the engines and the accounting shared by them
+ * @prefetched: engine that prefetched a page not referenced since, PREFETCH_NONE otherwise
+ * @ra: read-ahead engine, NULL if disabled
+ * @mk: correlation engine, NULL if disabled
+ * @stats: prefetch statistics per engine
+ */
+typedef struct prefetcher
+{
+  uint8_t prefetched[PAGES];
+  readahead *ra;
+  markov *mk;
+  prefetchstats stats[PREFETCH_SOURCES];
+} prefetcher;
+
+prefetcher *new_prefetcher(int readaheadwindow, int markovdegree, int markovtablesize);
+
+void free_prefetcher(prefetcher *);
+
+int prefetch_candidates(prefetcher *, const uint16_t vpn, prefetchcandidate *candidates, const int max);
+
+bool prefetch_onhit(prefetcher *, const uint16_t vpn);
+
+void prefetch_onissue(prefetcher *, const uint16_t vpn, PREFETCHSOURCE source);
+
+void prefetch_onevict(prefetcher *, const uint16_t vpn);
+
+void print_prefetchstats(prefetcher *, int demandfaults);
+
+#endif
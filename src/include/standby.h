@@ -0,0 +1,63 @@
+#ifndef STANDBY_H
+#define STANDBY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/**
+ * standby list statistics
+ * @inserted: evicted pages put on standby
+ * @reclaimed: refaults resolved from standby, each one a soft fault without I/O
+ * @repurposed: standby pages whose frame was acquired again before they were referenced again
+ */
+typedef struct standbystats
+{
+  unsigned long inserted;
+  unsigned long reclaimed;
+  unsigned long repurposed;
+} standbystats;
+
+/**
+ * standby list of recently evicted pages, kept on the free frames
+ * an evicted page keeps its contents in its frame while the frame is free, until the frame is acquired again,
+ * dirty pages are written back before their frame is freed so a standby page is always clean
+ * @reserve frames are kept free for standby on top of the frame a fault needs, they are taken from -f,
+ * free frames are acquired without standby contents first, then the one whose page was evicted the longest ago
+ * @reserve: frames kept free for standby pages
+ * @framecount: number of in-memory frames
+ * @pageof: page whose contents each free frame still holds, -1 if none
+ * @frameof: frame still holding each page, -1 if the page is not on standby
+ * @prev: previous frame in eviction order, -1 if none
+ * @next: next frame in eviction order, -1 if none
+ * @oldest: frame of the least recently evicted page on standby, -1 if the list is empty
+ * @newest: frame of the most recently evicted page on standby, -1 if the list is empty
+ * @stats: standby list statistics
+ */
+typedef struct standby
+{
+  int reserve;
+  int framecount;
+  int *pageof;
+  int frameof[PAGES];
+  int *prev;
+  int *next;
+  int oldest;
+  int newest;
+  standbystats stats;
+} standby;
+
+standby *new_standby(int reserve, int framecount);
+
+void free_standby(standby *);
+
+void standby_insert(standby *, const uint16_t vpn, const uint16_t frame);
+
+int standby_reclaim(standby *, const uint16_t vpn);
+
+void standby_repurpose(standby *, const uint16_t frame);
+
+void print_standbystats(const standby *);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SUBPAGE_H
+#define SUBPAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/* dirty tracking granularities in bytes */
+#define SUBPAGE_BYTE 1
+#define SUBPAGE_WORD 8
+#define SUBPAGE_LINE 64
+
+/**
+ * sub-page dirty tracking statistics
+ * @writebacks: dirty pages written back
+ * @fullpages: dirty pages written back whole because the swap layers in use only move whole pages
+ * @ranges: contiguous dirty ranges written
+ * @byteswritten: bytes written back, full pages included
+ */
+typedef struct subpagestats
+{
+  unsigned long writebacks;
+  unsigned long fullpages;
+  unsigned long ranges;
+  unsigned long byteswritten;
+} subpagestats;
+
+/**
+ * per-frame dirty bitmaps, a frame is split into units of @unitsize bytes
+ * and only the units written since the page was loaded go back to swap
+ * @unitsize: bytes covered by one dirty bit, SUBPAGE_BYTE, SUBPAGE_WORD or SUBPAGE_LINE
+ * @framecount: number of frames tracked
+ * @dirty: dirty units of each frame, bit n covers bytes n * @unitsize .. (n + 1) * @unitsize - 1
+ * @stats: sub-page dirty tracking statistics
+ */
+typedef struct subpage
+{
+  int unitsize;
+  int framecount;
+  uint64_t *dirty;
+  subpagestats stats;
+} subpage;
+
+subpage *new_subpage(int unitsize, int framecount);
+
+void free_subpage(subpage *);
+
+void subpage_clear(subpage *, const uint16_t frame);
+
+void subpage_mark(subpage *, const uint16_t frame, const uint16_t offset);
+
+bool subpage_writeback(subpage *, swapspace *, const uint16_t idx, const uint16_t frame, const page *);
+
+void print_subpagestats(const subpage *);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SWAPALLOC_H
+#define SWAPALLOC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "swapspace.h"
+
+/* the swap file grows by this many slots at a time, one O_DIRECT block */
+#define SWAPALLOC_CHUNK_SLOTS 64
+
+/* one bit per slot of the largest swap file the allocator can grow */
+#define SWAPALLOC_BITMAP_WORDS (PAGES / 64)
+
+/**
+ * swap slot allocator statistics
+ * @allocated: slots handed out
+ * @reused: allocations served by a previously freed slot
+ * @freed: slots given back, on write faults and when an all zero page is swapped out
+ * @grows: times the swap file was extended
+ * @peakslots: largest number of slots in use at once
+ */
+typedef struct swapallocstats
+{
+  unsigned long allocated;
+  unsigned long reused;
+  unsigned long freed;
+  unsigned long grows;
+  int peakslots;
+} swapallocstats;
+
+/**
+ * on-demand swap slot allocator for the compact layout
+ * a page gets a slot the first time it is written to swap, the lowest free slot is
+ * always taken so the file stays dense, and the file grows a chunk at a time only
+ * once every slot is in use
+ * the slot map only lives in memory, at shutdown every page is put back in its own slot and the file
+ * is sized to the fixed layout, so page n of an existing swap file is in slot n whatever layout wrote it
+ * @ss: swapspace the allocator hands out slots of
+ * @lock: protects everything below, the backing store mapping included
+ * @slotof: slot holding each page, -1 if the page has none
+ * @inuse: bitmap of slots holding a page
+ * @capacity: most slots the allocator may hand out
+ * @highwater: slots below this were handed out at least once
+ * @used: number of slots in use
+ * @stats: swap slot allocator statistics
+ */
+typedef struct swapalloc
+{
+  swapspace *ss;
+  pthread_mutex_t lock;
+  int slotof[PAGES];
+  uint64_t inuse[SWAPALLOC_BITMAP_WORDS];
+  int capacity;
+  int highwater;
+  int used;
+  swapallocstats stats;
+} swapalloc;
+
+swapalloc *new_swapalloc(swapspace *);
+
+void free_swapalloc(swapalloc *);
+
+void swapalloc_reset(swapalloc *, int capacity);
+
+bool swapalloc_full(swapalloc *);
+
+bool swapalloc_holds(swapalloc *, const uint16_t vpn);
+
+bool swapalloc_store(swapalloc *, const uint16_t vpn, const page *pages[], const int n);
+
+bool swapalloc_read(swapalloc *, const uint16_t vpn, page *);
+
+bool swapalloc_sync(swapalloc *);
+
+void swapalloc_discard(swapalloc *, const uint16_t vpn);
+
+void print_swapallocstats(swapalloc *);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SWAPBACKEND_H
+#define SWAPBACKEND_H
+
+#include "memsimarg.h"
+#include "swapspace.h"
+
+/* O_DIRECT transfers are aligned to this many bytes, offsets and lengths alike */
+#define DIRECT_ALIGNMENT 4096
+
+/* submission queue depth of the io_uring instance */
+#define URING_ENTRIES 8
+
+/**
+ * swap I/O backend, every page transfer between memory and the backing store goes through one
+ * @name: name used on the command line
+ * @open: prepares the backend once the backing store file has its final size
+ * @read: copies page idx of the backing store into pg
+ * @write: writes n pages to consecutive slots starting at idx
+ * @writebytes: writes length bytes of data at offset within slot idx, the rest of the slot is left as is
+ * @sync: makes slots idx .. idx + n - 1 durable
+ * @resize: follows the backing store file after it changed size, oldsize is its size before
+ * @close: releases everything acquired by open
+ */
+typedef struct swapbackend
+{
+  const char *name;
+  bool (*open)(swapspace *);
+  bool (*read)(swapspace *, const uint16_t idx, page *pg);
+  bool (*write)(swapspace *, const uint16_t idx, const page *pages[], const int n);
+  bool (*writebytes)(swapspace *, const uint16_t idx, const int offset, const uint8_t *data, const int length);
+  bool (*sync)(swapspace *, const uint16_t idx, const int n);
+  bool (*resize)(swapspace *, const size_t oldsize);
+  void (*close)(swapspace *);
+} swapbackend;
+
+const swapbackend *get_swapbackend(SWAPIO);
+
+#endif
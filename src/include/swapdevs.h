@@ -0,0 +1,58 @@
+#ifndef SWAPDEVS_H
+#define SWAPDEVS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "swapspace.h"
+
+/**
+ * swap device, a swap file of its own in the compact layout
+ * @ss: the device's swapspace, the first device is the simulator's swapspace itself
+ * @priority: devices with a higher priority are used first
+ * @placed: pages placed on the device so far
+ */
+typedef struct swapdevice
+{
+  swapspace *ss;
+  int priority;
+  unsigned long placed;
+} swapdevice;
+
+/**
+ * prioritized swap devices
+ * a page stays on the device it was first placed on as long as that device holds it,
+ * new pages go to the highest priority group with a device that is not full and are
+ * striped round robin across the devices of that group
+ * additional devices start out empty, like a freshly enabled swap area
+ * @lock: protects the placement state, each device serializes its own I/O
+ * @count: number of devices
+ * @devices: devices by decreasing priority, equal priorities keep the order they were added in
+ * @deviceof: device holding each page, -1 if the page is on none
+ * @cursor: next device to place a page on, per group, indexed by the group's first device
+ */
+typedef struct swapdevs
+{
+  pthread_mutex_t lock;
+  int count;
+  swapdevice devices[MAX_SWAPDEVICES];
+  int8_t deviceof[PAGES];
+  int cursor[MAX_SWAPDEVICES];
+} swapdevs;
+
+bool add_swapdevice(swapspace *, char *filename, int priority, int slots, SWAPIO swapio);
+
+void free_swapdevs(swapdevs *, bool sync);
+
+bool swapdevs_store(swapdevs *, const uint16_t vpn, const page *pages[], const int n);
+
+bool swapdevs_read(swapdevs *, const uint16_t vpn, page *);
+
+bool swapdevs_sync(swapdevs *);
+
+void swapdevs_discard(swapdevs *, const uint16_t vpn);
+
+void print_swapdevsstats(swapdevs *);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SWAPLOG_H
+#define SWAPLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "swapspace.h"
+
+/* pages per log segment, the unit of every sequential write */
+#define SWAPLOG_SEGMENT_PAGES 16
+
+/* segments in the log, twice the address space so the cleaner always finds dead pages */
+#define SWAPLOG_SEGMENTS (2 * PAGES / SWAPLOG_SEGMENT_PAGES)
+
+/* slots in a log-structured swap file */
+#define SWAPLOG_SLOTS (SWAPLOG_SEGMENTS * SWAPLOG_SEGMENT_PAGES)
+
+/* the cleaner runs while no more than this many segments are free */
+#define SWAPLOG_CLEAN_WATERMARK 8
+
+/* free segments only the cleaner may take, evictions wait for it below this */
+#define SWAPLOG_RESERVE 1
+
+/**
+ * log-structured swap statistics
+ * @logicalwrites: pages handed to the log by evictions
+ * @physicalwrites: pages written to the swap file, relocated pages included
+ * @writecalls: sequential writes issued, one per segment or segment tail
+ * @cleaned: segments reclaimed by the cleaner
+ * @relocated: live pages the cleaner copied out of reclaimed segments
+ * @stalls: appends that had to wait for the cleaner to free a segment
+ */
+typedef struct swaplogstats
+{
+  unsigned long logicalwrites;
+  unsigned long physicalwrites;
+  unsigned long writecalls;
+  unsigned long cleaned;
+  unsigned long relocated;
+  unsigned long stalls;
+} swaplogstats;
+
+/**
+ * log-structured swap layout
+ * evicted pages are appended to the open segment, which is written out as a single
+ * sequential run once full; a background cleaner copies the live pages out of the
+ * emptiest segments to keep segments free
+ * the remap table only lives in memory, at shutdown every page is put back in its own slot and the file
+ * is cut to the fixed layout, so page n of an existing swap file is in slot n whatever layout wrote it
+ * @ss: swapspace the log is laid over
+ * @cleaner: cleaner thread
+ * @lock: protects everything below
+ * @needclean: signalled when free segments run low
+ * @segmentfree: signalled whenever the cleaner frees a segment
+ * @slotof: slot holding the newest copy of each page, -1 if the page was never written
+ * @ownerof: page whose newest copy is in each slot, -1 for free or dead slots
+ * @live: number of live slots in each segment
+ * @isfree: segments that hold no data and can be opened
+ * @freecount: number of free segments
+ * @opensegment: segment appended to, -1 before the first append
+ * @fill: pages appended to the open segment
+ * @flushed: pages of the open segment already written to the swap file
+ * @buffer: contents of the open segment
+ * @stop: set on shutdown
+ * @stats: log-structured swap statistics
+ */
+typedef struct swaplog
+{
+  swapspace *ss;
+  pthread_t cleaner;
+  pthread_mutex_t lock;
+  pthread_cond_t needclean;
+  pthread_cond_t segmentfree;
+  int slotof[PAGES];
+  int ownerof[SWAPLOG_SLOTS];
+  int live[SWAPLOG_SEGMENTS];
+  bool isfree[SWAPLOG_SEGMENTS];
+  int freecount;
+  int opensegment;
+  int fill;
+  int flushed;
+  page buffer[SWAPLOG_SEGMENT_PAGES];
+  bool stop;
+  swaplogstats stats;
+} swaplog;
+
+swaplog *new_swaplog(swapspace *);
+
+void free_swaplog(swaplog *);
+
+bool swaplog_append(swaplog *, const uint16_t vpn, const page *pages[], const int n);
+
+bool swaplog_read(swaplog *, const uint16_t vpn, page *);
+
+bool swaplog_flush(swaplog *);
+
+void swaplog_discard(swaplog *, const uint16_t vpn);
+
+void print_swaplogstats(swaplog *);
+
+#endif
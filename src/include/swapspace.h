@@ -4,6 +4,9 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
+
+#include "memsimarg.h"
 
 /* page size in bytes */
 #define PAGESIZE 64
@@ -20,11 +23,49 @@ page new_page(void);
 
 typedef int ss_descriptor;
 
+struct writeback;
+struct swapbackend;
+struct zpool;
+struct swaplog;
+struct swapalloc;
+struct swapdevs;
+
+/**
+ * swap I/O statistics, updated by whichever thread performs the transfer
+ * @reads: pages read from the backing store
+ * @writes: pages written to the backing store
+ * @writecalls: backend write calls, one per contiguous run of pages or per partial page range
+ * @rangewrites: writes of a byte range within a page, counted in @writecalls but not in @writes
+ * @readtime: time spent in backend reads in microseconds
+ * @writetime: time spent in backend writes in microseconds
+ */
+typedef struct swapiostats
+{
+  unsigned long reads;
+  unsigned long writes;
+  unsigned long writecalls;
+  unsigned long rangewrites;
+  double readtime;
+  double writetime;
+} swapiostats;
+
 /**
  * swapspace structs for the virtual memory backing store
  * @filename: filename of the backing store file, maximum characters can be 63 (excluding the NULL character)
  * @pages: backing store pages, maximum 1024 pages
- * @memorymap: backing store mmap
+ * @memorymap: backing store mmap, only kept by the mmap backend
+ * @nslots: number of page slots in the backing store file
+ * @backend: swap I/O backend every page transfer goes through
+ * @backenddata: backend private state
+ * @wb: background writeback, NULL if pages are written synchronously
+ * @zp: compressed pool in front of the backing store, NULL if disabled
+ * @log: log-structured layout, NULL if page n lives in slot n
+ * @alloc: on-demand slot allocator of the compact layout, NULL if page n lives in slot n
+ * @devs: swap devices pages are spread over, this swapspace being the first, NULL if it is the only one
+ * @durability: when the backing store mapping is msync'ed
+ * @syncs: number of syncs issued so far
+ * @iostats: swap I/O statistics
+ * @backed: bitmap of swap slots that hold data, the other slots were never written and read as zeros
  */
 typedef struct swapspace
 {
@@ -32,6 +73,18 @@ typedef struct swapspace
   ss_descriptor descriptor;
   page *memorymap;
   size_t size;
+  int nslots;
+  const struct swapbackend *backend;
+  void *backenddata;
+  struct writeback *wb;
+  struct zpool *zp;
+  struct swaplog *log;
+  struct swapalloc *alloc;
+  struct swapdevs *devs;
+  DURABILITY durability;
+  atomic_ulong syncs;
+  swapiostats iostats;
+  uint64_t backed[PAGES / 64];
 } swapspace;
 
 typedef struct newswapspace
@@ -40,16 +93,36 @@ typedef struct newswapspace
   bool isnew;
 } newswapspace;
 
-newswapspace new_swapspace(char *filename);
+newswapspace new_swapspace(char *filename, SWAPIO swapio, SWAPLAYOUT swaplayout);
 
 void free_swapspace(swapspace **);
 
-page *get_pagecpy(const swapspace *, const uint16_t idx);
+bool resize_backingstore(swapspace *, int nslots);
+
+page *get_pagecpy(swapspace *, const uint16_t idx);
 
 bool write_page(swapspace *, const uint16_t idx, const page *);
 
+bool has_backingdata(const swapspace *, const uint16_t idx);
+
+void discard_swapcopy(swapspace *, const uint16_t idx);
+
+bool store_pages(swapspace *, const uint16_t idx, const page *pages[], const int n);
+
+bool write_slots(swapspace *, const uint16_t slot, const page *pages[], const int n);
+
+bool read_slot(swapspace *, const uint16_t slot, page *);
+
+bool can_writeranges(const swapspace *);
+
+bool write_range(swapspace *, const uint16_t idx, const int offset, const int length, const page *);
+
+bool sync_swapspace(swapspace *, const uint16_t idx, const int n);
+
 void walk_swapspace(const swapspace *);
 
-bool validate_newswapspace(const swapspace *);
+bool validate_newswapspace(swapspace *);
+
+void print_swapiostats(const swapspace *);
 
 #endif
\ No newline at end of file
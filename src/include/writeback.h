@@ -0,0 +1,102 @@
+#ifndef WRITEBACK_H
+#define WRITEBACK_H
+
+#include <pthread.h>
+#include <time.h>
+
+#include "swapspace.h"
+
+/**
+ * writeback queue entry
+ * @idx: swapspace page index the dirty frame is written to
+ * @content: copy of the dirty frame taken at eviction time
+ * @queued: time at which the frame was handed to the writeback thread
+ */
+typedef struct writebackentry
+{
+  uint16_t idx;
+  page content;
+  struct timespec queued;
+} writebackentry;
+
+/**
+ * writeback statistics
+ * @pagesflushed: number of pages written to the swapspace by the thread
+ * @coalesced: dirty evictions that replaced an already queued copy of the same page
+ * @batches: number of batches taken off the queue (synced as a whole only in every-evict durability mode)
+ * @runs: number of contiguous page runs written
+ * @maxbatch: largest batch flushed at once
+ * @stalls: evictions that had to wait because the queue was full
+ * @totallatency: sum of latencies from enqueue to the end of the batch write in microseconds
+ * @maxlatency: worst latency from enqueue to the end of the batch write in microseconds
+ * @depthsamples: number of queue depth samples (one per enqueue)
+ * @totaldepth: sum of sampled queue depths
+ * @maxdepth: deepest queue observed
+ */
+typedef struct writebackstats
+{
+  unsigned long pagesflushed;
+  unsigned long coalesced;
+  unsigned long batches;
+  unsigned long runs;
+  int maxbatch;
+  unsigned long stalls;
+  double totallatency;
+  double maxlatency;
+  unsigned long depthsamples;
+  unsigned long totaldepth;
+  int maxdepth;
+} writebackstats;
+
+/**
+ * background dirty page writeback
+ * dirty frames are queued by the fault path and flushed by a dedicated thread,
+ * sorted by swap slot so that contiguous pages are written together
+ * @ss: swapspace the pages are flushed to
+ * @thread: writeback thread
+ * @lock: protects everything below
+ * @notempty: signalled when entries are queued or on shutdown
+ * @notfull: signalled when the thread empties the queue
+ * @idle: signalled when the thread has nothing queued or in flight
+ * @queue: pending entries, at most @capacity
+ * @count: number of pending entries
+ * @capacity: maximum number of pending entries before evictions block
+ * @pendingpos: position of a page index in @queue, -1 if not pending
+ * @batch: entries currently being flushed by the thread
+ * @batchsize: number of entries in @batch, 0 when the thread is idle
+ * @inflightpos: position of a page index in @batch, -1 if not in flight
+ * @stop: set on shutdown, the thread drains the queue and exits
+ * @stats: writeback statistics
+ */
+typedef struct writeback
+{
+  swapspace *ss;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t notempty;
+  pthread_cond_t notfull;
+  pthread_cond_t idle;
+  writebackentry *queue;
+  int count;
+  int capacity;
+  int pendingpos[PAGES];
+  writebackentry *batch;
+  int batchsize;
+  int inflightpos[PAGES];
+  bool stop;
+  writebackstats stats;
+} writeback;
+
+writeback *new_writeback(swapspace *, int capacity);
+
+void free_writeback(writeback *);
+
+void writeback_enqueue(writeback *, const uint16_t idx, const page *);
+
+bool writeback_lookup(writeback *, const uint16_t idx, page *);
+
+void writeback_drain(writeback *);
+
+void print_writebackstats(writeback *);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef ZPOOL_H
+#define ZPOOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "swapspace.h"
+
+/**
+ * compressed copy of an evicted page
+ * @data: compressed content, NULL for same-filled pages
+ * @size: compressed size in bytes, 0 for same-filled pages
+ * @fill: the repeated byte of a same-filled page
+ * @stored: the entry holds the newest content of its swap slot
+ */
+typedef struct zpoolentry
+{
+  uint8_t *data;
+  uint16_t size;
+  uint8_t fill;
+  bool stored;
+} zpoolentry;
+
+/**
+ * compressed pool statistics
+ * @stores: pages accepted by the pool
+ * @samefilled: accepted pages made of a single repeated byte, zero pages included
+ * @zerofilled: same-filled pages whose byte is zero
+ * @rejected: pages that did not compress below a page and went to swap directly
+ * @bytesin: uncompressed bytes of every accepted page
+ * @bytesout: compressed bytes of every accepted page
+ * @hits: swap reads served by the pool
+ * @misses: swap reads the pool could not serve
+ * @writebacks: pool entries pushed out to swap to stay within the budget
+ */
+typedef struct zpoolstats
+{
+  unsigned long stores;
+  unsigned long samefilled;
+  unsigned long zerofilled;
+  unsigned long rejected;
+  unsigned long bytesin;
+  unsigned long bytesout;
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long writebacks;
+} zpoolstats;
+
+/**
+ * in-memory compressed tier in front of the swap file (zswap like)
+ * entries stay in the pool after a load, a clean page can be evicted again
+ * without being written anywhere; the oldest entries go to swap once the pool
+ * holds more than its budget
+ * @budget: maximum number of compressed bytes held
+ * @used: compressed bytes currently held
+ * @entries: compressed copy of each swap slot
+ * @prev: previous slot in store order, -1 if none
+ * @next: next slot in store order, -1 if none
+ * @oldest: least recently stored slot, -1 if the pool is empty
+ * @newest: most recently stored slot, -1 if the pool is empty
+ * @count: number of slots held
+ * @stats: compressed pool statistics
+ */
+typedef struct zpool
+{
+  unsigned long budget;
+  unsigned long used;
+  zpoolentry entries[PAGES];
+  int prev[PAGES];
+  int next[PAGES];
+  int oldest;
+  int newest;
+  int count;
+  zpoolstats stats;
+} zpool;
+
+zpool *new_zpool(unsigned long budget);
+
+void free_zpool(zpool *);
+
+bool zpool_store(zpool *, const uint16_t idx, const page *);
+
+bool zpool_load(zpool *, const uint16_t idx, page *);
+
+void zpool_invalidate(zpool *, const uint16_t idx);
+
+bool zpool_overbudget(const zpool *);
+
+bool zpool_evict(zpool *, uint16_t *idx, page *);
+
+void print_zpoolstats(const zpool *, const swapiostats *);
+
+#endif
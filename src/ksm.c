@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ksm.h"
+#include "framehash.h"
+
+#define IS_DIRTY(bitmap, frame) ((bitmap[(frame) >> 6] >> ((frame) & 63)) & 1)
+
+ksm *new_ksm(int pagestoscan, int framecount)
+{
+  ksm *km = (ksm *)malloc(sizeof(ksm));
+  km->pagestoscan = pagestoscan < framecount ? pagestoscan : framecount;
+  km->cursor = 0;
+  km->hashes = (uint64_t *)calloc(framecount, sizeof(uint64_t));
+  km->hashed = (bool *)calloc(framecount, sizeof(bool));
+  memset(&(km->stats), 0, sizeof(ksmstats));
+  return km;
+}
+
+void free_ksm(ksm *km)
+{
+  if (km)
+  {
+    free(km->hashes);
+    free(km->hashed);
+    free(km);
+  }
+}
+
+// gained_frames: pages resident beyond the frames they occupy
+static int gained_frames(const framepool *frames)
+{
+  int pages = 0;
+  for (int i = 0; i < frames->framecount; i++)
+  {
+    pages += frames->sharers[i];
+  }
+  return pages - (frames->framecount - frames->nfree - frames->nheld);
+}
+
+// find_twin: a clean frame other than frame with the same contents, merged frames first, -1 if none
+// hashes only narrow the search down, a twin always has its contents compared
+static int find_twin(ksm *km, framepool *frames, page *memory, const uint64_t *dirtyframes, const int frame)
+{
+  int twin = -1;
+  for (int i = 0; i < frames->framecount; i++)
+  {
+    if (i == frame || (!km->hashed[i] && frames->sharers[i] < 2))
+      continue;
+    if (frames->sharers[i] == 0 || IS_DIRTY(dirtyframes, i) || km->hashes[i] != km->hashes[frame])
+      continue;
+    if (memcmp(memory + i, memory + frame, sizeof(page)) != 0)
+      continue;
+    twin = i;
+    if (frames->sharers[i] > 1)
+      break;
+  }
+  return twin;
+}
+
+void ksm_scan(ksm *km, framepool *frames, page *memory, const uint64_t *dirtyframes, PAGETABLE type, void *vpt)
+{
+  for (int n = 0; n < km->pagestoscan; n++)
+  {
+    int frame = km->cursor;
+    km->cursor = (km->cursor + 1) % frames->framecount;
+    km->stats.scanned++;
+    // free frames have nothing to merge, written pages are likely to be written again
+    if (frames->sharers[frame] != 1 || IS_DIRTY(dirtyframes, frame))
+    {
+      km->hashed[frame] = frames->sharers[frame] > 1;
+      continue;
+    }
+    km->hashes[frame] = hash_page(memory + frame);
+    km->hashed[frame] = true;
+
+    int twin = find_twin(km, frames, memory, dirtyframes, frame);
+    if (twin == -1)
+      continue;
+    // the page moves onto its twin, its own frame is free from here on
+    uint16_t vpn = (uint16_t)frames->firstpage[frame];
+    update_framenumber(type, vpt, vpn << 6, twin);
+    unmap_frame(frames, frame, vpn);
+    map_frame(frames, twin, vpn);
+    km->hashed[frame] = false;
+    km->hashed[twin] = true;
+    km->stats.merged++;
+  }
+
+  int gained = gained_frames(frames);
+  km->stats.samples++;
+  km->stats.gainedtotal += gained;
+  if (gained > km->stats.gainedpeak)
+    km->stats.gainedpeak = gained;
+}
+
+void print_ksmstats(const ksm *km, const framepool *frames)
+{
+  const ksmstats *stats = &(km->stats);
+  printf("ksm pages to scan: %d per tick, frames scanned: %lu\n", km->pagestoscan, stats->scanned);
+  printf("ksm pages merged: %lu, copy-on-write breaks: %lu\n", stats->merged, stats->cowbreaks);
+  printf("ksm effective frames gained: %d now, avg %.2f, peak %d (of %d frames)\n",
+         gained_frames(frames),
+         stats->samples ? (double)stats->gainedtotal / stats->samples : 0.0,
+         stats->gainedpeak,
+         frames->framecount);
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kswapd.h"
+
+kswapd *new_kswapd(int low, int high)
+{
+  kswapd *kd = (kswapd *)malloc(sizeof(kswapd));
+  kd->low = low;
+  kd->high = high;
+  memset(&(kd->stats), 0, sizeof(kswapdstats));
+  return kd;
+}
+
+void free_kswapd(kswapd *kd)
+{
+  free(kd);
+}
+
+bool kswapd_shouldwake(const kswapd *kd, const int nfree)
+{
+  return nfree < kd->low;
+}
+
+void kswapd_onfault(kswapd *kd, const int evictions)
+{
+  kd->stats.faults++;
+  if (evictions > 0)
+  {
+    kd->stats.directfaults++;
+    kd->stats.directevictions += evictions;
+  }
+}
+
+void kswapd_onreclaim(kswapd *kd, const int evictions)
+{
+  kd->stats.wakeups++;
+  kd->stats.backgroundevictions += evictions;
+}
+
+void print_kswapdstats(const kswapd *kd)
+{
+  const kswapdstats *stats = &(kd->stats);
+  printf("reclaim watermarks: low %d, high %d free frames\n", kd->low, kd->high);
+  printf("reclaim direct: %lu pages evicted by %lu of %lu faults (%.2f%% found a free frame)\n",
+         stats->directevictions,
+         stats->directfaults,
+         stats->faults,
+         stats->faults ? 100.0 * (stats->faults - stats->directfaults) / stats->faults : 0.0);
+  printf("reclaim background: %lu pages evicted in %lu wakeups (avg batch %.2f)\n",
+         stats->backgroundevictions,
+         stats->wakeups,
+         stats->wakeups ? (double)stats->backgroundevictions / stats->wakeups : 0.0);
+}
@@ -18,15 +18,20 @@ int main(const int argc, const char *argv[])
   print_cmdargs(process_args);
   printf("*****************************\n");
 
-  simulator = new_memsim(
-      process_args->level,
-      process_args->fcount,
-      process_args->swapfile,
-      process_args->outfile,
-      process_args->algo);
+  simulator = new_memsim(process_args);
+  if (simulator == NULL)
+    goto exit;
 
   read_source(simulator, process_args->addrfile, process_args->tick);
   printf("DONE\n");
+
+  printf("***** MEMSIM SUMMARY ********\n");
+  print_summary(simulator);
+  printf("*****************************\n");
+
+  free_memsim(simulator);
+  free_cmdargs(process_args);
+  exit(EXIT_SUCCESS);
 exit:
   free_cmdargs(process_args);
   exit(EXIT_FAILURE);
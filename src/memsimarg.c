@@ -2,6 +2,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "memsimarg.h"
+#include "swapspace.h"
+#include "prefetch.h"
+#include "subpage.h"
 
 /**
  * this function maps string repr of algorithm to enum
@@ -26,6 +29,42 @@ ALGO get_algo(const char *algo_str)
   {
     return ECLOCK;
   }
+  else if (strcmp(algo_str, "OPT") == 0)
+  {
+    return OPT;
+  }
+  else if (strcmp(algo_str, "ARC") == 0)
+  {
+    return ARC;
+  }
+  else if (strcmp(algo_str, "CLOCKPRO") == 0)
+  {
+    return CLOCKPRO;
+  }
+  else if (strcmp(algo_str, "MGLRU") == 0)
+  {
+    return MGLRU;
+  }
+  else if (strcmp(algo_str, "AGING") == 0)
+  {
+    return AGING;
+  }
+  else if (strcmp(algo_str, "WSCLOCK") == 0)
+  {
+    return WSCLOCK;
+  }
+  else if (strcmp(algo_str, "LFU") == 0)
+  {
+    return LFU;
+  }
+  else if (strcmp(algo_str, "ADAPTIVE") == 0)
+  {
+    return ADAPTIVE;
+  }
+  else if (strncmp(algo_str, "plugin:", 7) == 0 && algo_str[7] != '\0')
+  {
+    return PLUGIN;
+  }
 
   return INVALID_ALGO;
 }
@@ -59,6 +98,191 @@ void get_algo_str(ALGO algo, char **algo_str)
     *algo_str = (char *)malloc(sizeof(char) * 7);
     strcpy(*algo_str, "ECLOCK");
   }
+  else if (algo == OPT)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 4);
+    strcpy(*algo_str, "OPT");
+  }
+  else if (algo == ARC)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 4);
+    strcpy(*algo_str, "ARC");
+  }
+  else if (algo == CLOCKPRO)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 9);
+    strcpy(*algo_str, "CLOCKPRO");
+  }
+  else if (algo == MGLRU)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 6);
+    strcpy(*algo_str, "MGLRU");
+  }
+  else if (algo == AGING)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 6);
+    strcpy(*algo_str, "AGING");
+  }
+  else if (algo == WSCLOCK)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 8);
+    strcpy(*algo_str, "WSCLOCK");
+  }
+  else if (algo == LFU)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 4);
+    strcpy(*algo_str, "LFU");
+  }
+  else if (algo == ADAPTIVE)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 9);
+    strcpy(*algo_str, "ADAPTIVE");
+  }
+  else if (algo == PLUGIN)
+  {
+    *algo_str = (char *)malloc(sizeof(char) * 7);
+    strcpy(*algo_str, "PLUGIN");
+  }
+}
+
+/**
+ * this function maps string repr of a durability mode to enum
+ * @durability_str: the string repr of the mode, without the --durability= prefix
+ * @period: set to N for periodic:N
+ */
+DURABILITY get_durability(const char *durability_str, int *period)
+{
+  if (strcmp(durability_str, "none") == 0)
+  {
+    return DURABILITY_NONE;
+  }
+  else if (strcmp(durability_str, "end") == 0)
+  {
+    return DURABILITY_END;
+  }
+  else if (strcmp(durability_str, "every-evict") == 0)
+  {
+    return DURABILITY_EVERY_EVICT;
+  }
+  else if (strncmp(durability_str, "periodic:", 9) == 0)
+  {
+    *period = atoi(durability_str + 9);
+    if (*period <= 0)
+    {
+      return INVALID_DURABILITY;
+    }
+    return DURABILITY_PERIODIC;
+  }
+
+  return INVALID_DURABILITY;
+}
+
+const char *get_durability_str(DURABILITY durability)
+{
+  switch (durability)
+  {
+  case DURABILITY_NONE:
+    return "none";
+  case DURABILITY_END:
+    return "end";
+  case DURABILITY_PERIODIC:
+    return "periodic";
+  case DURABILITY_EVERY_EVICT:
+    return "every-evict";
+  }
+  return "invalid";
+}
+
+SWAPIO get_swapio(const char *swapio_str)
+{
+  if (strcmp(swapio_str, "mmap") == 0)
+  {
+    return SWAPIO_MMAP;
+  }
+  else if (strcmp(swapio_str, "pread") == 0)
+  {
+    return SWAPIO_PREAD;
+  }
+  else if (strcmp(swapio_str, "direct") == 0)
+  {
+    return SWAPIO_DIRECT;
+  }
+  else if (strcmp(swapio_str, "uring") == 0)
+  {
+    return SWAPIO_URING;
+  }
+
+  return INVALID_SWAPIO;
+}
+
+const char *get_swapio_str(SWAPIO swapio)
+{
+  switch (swapio)
+  {
+  case SWAPIO_MMAP:
+    return "mmap";
+  case SWAPIO_PREAD:
+    return "pread";
+  case SWAPIO_DIRECT:
+    return "direct";
+  case SWAPIO_URING:
+    return "uring";
+  }
+  return "invalid";
+}
+
+SWAPLAYOUT get_swaplayout(const char *swaplayout_str)
+{
+  if (strcmp(swaplayout_str, "fixed") == 0)
+  {
+    return SWAPLAYOUT_FIXED;
+  }
+  else if (strcmp(swaplayout_str, "log") == 0)
+  {
+    return SWAPLAYOUT_LOG;
+  }
+  else if (strcmp(swaplayout_str, "compact") == 0)
+  {
+    return SWAPLAYOUT_COMPACT;
+  }
+
+  return INVALID_SWAPLAYOUT;
+}
+
+const char *get_swaplayout_str(SWAPLAYOUT swaplayout)
+{
+  switch (swaplayout)
+  {
+  case SWAPLAYOUT_FIXED:
+    return "fixed";
+  case SWAPLAYOUT_LOG:
+    return "log";
+  case SWAPLAYOUT_COMPACT:
+    return "compact";
+  }
+  return "invalid";
+}
+
+/**
+ * this function maps string repr of a dirty tracking granularity to its size in bytes
+ * @granularity_str: byte, word (8 bytes) or line (a cache line)
+ */
+int get_dirtygranularity(const char *granularity_str)
+{
+  if (strcmp(granularity_str, "byte") == 0)
+  {
+    return SUBPAGE_BYTE;
+  }
+  else if (strcmp(granularity_str, "word") == 0)
+  {
+    return SUBPAGE_WORD;
+  }
+  else if (strcmp(granularity_str, "line") == 0)
+  {
+    return SUBPAGE_LINE;
+  }
+
+  return -1;
 }
 
 cmd_args *new_cmdargs(void)
@@ -69,7 +293,31 @@ cmd_args *new_cmdargs(void)
   args->outfile = NULL;
   args->fcount = -1;
   args->algo = FIFO;
+  args->pluginpath = NULL;
   args->tick = -1;
+  args->writeback = 0;
+  args->durability = DURABILITY_END;
+  args->syncperiod = 0;
+  args->swapio = SWAPIO_MMAP;
+  args->readahead = 0;
+  args->markovdegree = 0;
+  args->markovtablesize = MARKOV_DEFAULT_TABLESIZE;
+  args->zswap = 0;
+  args->standby = 0;
+  args->swaplayout = SWAPLAYOUT_FIXED;
+  args->swapdevcount = 0;
+  args->dirtygranularity = 0;
+  args->elidesilent = false;
+  args->ksm = 0;
+  args->lowwatermark = 0;
+  args->highwatermark = 0;
+  args->generations = MGLRU_DEFAULT_GENERATIONS;
+  args->agebits = AGING_DEFAULT_BITS;
+  args->tau = WSCLOCK_DEFAULT_TAU;
+  args->pfflow = 0;
+  args->pffhigh = 0;
+  args->pffwindow = PFF_DEFAULT_WINDOW;
+  args->pffmin = 4;
   return args;
 }
 
@@ -91,6 +339,16 @@ void free_cmdargs(cmd_args *args)
     {
       free(args->outfile);
     }
+
+    if (args->pluginpath != NULL)
+    {
+      free(args->pluginpath);
+    }
+
+    for (int i = 0; i < args->swapdevcount; i++)
+    {
+      free(args->swapdevs[i].path);
+    }
     free(args);
   }
 }
@@ -104,6 +362,10 @@ void print_cmdargs(const cmd_args *args)
   get_algo_str(args->algo, &algo_str);
   printf("-a [algo]: %s (%d)\n", algo_str, args->algo);
   free(algo_str);
+  if (args->pluginpath != NULL)
+  {
+    printf("-a [plugin]: %s\n", args->pluginpath);
+  }
 
   printf("-t [tick]: %d\n", args->tick);
   if (args->addrfile != NULL)
@@ -132,6 +394,39 @@ void print_cmdargs(const cmd_args *args)
   {
     fprintf(stderr, "[ERROR] outfile not found");
   }
+
+  printf("--writeback [depth]: %d\n", args->writeback);
+  if (args->durability == DURABILITY_PERIODIC)
+  {
+    printf("--durability [mode]: %s:%d\n", get_durability_str(args->durability), args->syncperiod);
+  }
+  else
+  {
+    printf("--durability [mode]: %s\n", get_durability_str(args->durability));
+  }
+  printf("--swapio [backend]: %s\n", get_swapio_str(args->swapio));
+  printf("--readahead [pages]: %d\n", args->readahead);
+  printf("--markov [degree:entries]: %d:%d\n", args->markovdegree, args->markovtablesize);
+  printf("--zswap [bytes]: %d\n", args->zswap);
+  printf("--standby [frames]: %d\n", args->standby);
+  printf("--swaplayout [layout]: %s\n", get_swaplayout_str(args->swaplayout));
+  for (int i = 0; i < args->swapdevcount; i++)
+  {
+    printf("--swapdev [priority:slots:path]: %d:%d:%s\n",
+           args->swapdevs[i].priority,
+           args->swapdevs[i].slots,
+           args->swapdevs[i].path);
+  }
+  printf("--dirtygran [bytes]: %d\n", args->dirtygranularity);
+  printf("--elidesilent: %s\n", args->elidesilent ? "on" : "off");
+  printf("--ksm [pages]: %d\n", args->ksm);
+  printf("--watermarks [low:high]: %d:%d\n", args->lowwatermark, args->highwatermark);
+  printf("--generations [n]: %d\n", args->generations);
+  printf("--agebits [n]: %d\n", args->agebits);
+  printf("--tau [references]: %d\n", args->tau);
+  printf("--pff [low:high]: %.2f:%.2f\n", args->pfflow, args->pffhigh);
+  printf("--pffwindow [references]: %d\n", args->pffwindow);
+  printf("--pffmin [frames]: %d\n", args->pffmin);
 }
 
 #define HAS_LEVEL (int)0x0000001
@@ -146,7 +441,7 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
 {
   int validation = 0;
 
-  if (argc != 15)
+  if (argc < 15)
   {
     fprintf(stderr, "[ERROR] incomplete args\n");
     return false;
@@ -179,7 +474,7 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
         fprintf(stderr, "[ERROR] -r requires a value\n");
         return false;
       }
-      int addrfile_length = sizeof(argv[i + 1]);
+      int addrfile_length = strlen(argv[i + 1]) + 1;
       args->addrfile = (char *)malloc(addrfile_length);
       strcpy(args->addrfile, argv[i + 1]);
       validation = validation | HAS_ADDRFILE;
@@ -192,7 +487,7 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
         fprintf(stderr, "[ERROR] -s requires a value\n");
         return false;
       }
-      int swapfile_length = sizeof(argv[i + 1]);
+      int swapfile_length = strlen(argv[i + 1]) + 1;
       args->swapfile = (char *)malloc(swapfile_length);
       strcpy(args->swapfile, argv[i + 1]);
       validation = validation | HAS_SWAPFILE;
@@ -225,9 +520,15 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
       ALGO algo = get_algo(argv[i + 1]);
       if (algo == INVALID_ALGO)
       {
-        fprintf(stderr, "[ERROR] -a can only have FIFO, LRU, CLOCK or ECLOCK\n");
+        fprintf(stderr, "[ERROR] -a can only have FIFO, LRU, CLOCK, ECLOCK, OPT, ARC, CLOCKPRO, MGLRU, AGING, WSCLOCK, LFU, ADAPTIVE or plugin:<path>\n");
         return false;
       }
+      if (algo == PLUGIN)
+      {
+        free(args->pluginpath);
+        args->pluginpath = (char *)malloc(sizeof(char) * (strlen(argv[i + 1] + 7) + 1));
+        strcpy(args->pluginpath, argv[i + 1] + 7);
+      }
       args->algo = algo;
       validation = validation | HAS_ALGO;
     }
@@ -251,13 +552,244 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
         fprintf(stderr, "[ERROR] -o requires a value\n");
         return false;
       }
-      int outfile_length = sizeof(argv[i + 1]);
+      int outfile_length = strlen(argv[i + 1]) + 1;
       args->outfile = (char *)malloc(sizeof(char) * outfile_length);
       strcpy(args->outfile, argv[i + 1]);
       validation = validation | HAS_OUTFILE;
+    }
+    else if (strncmp(argv[i], "--writeback=", 12) == 0)
+    {
+      /* validate optional writeback queue depth */
+      int depth = atoi(argv[i] + 12);
+      if (depth < 0 || depth > PAGES)
+      {
+        fprintf(stderr, "[ERROR] --writeback can only have a value between 0 and %d\n", PAGES);
+        return false;
+      }
+      args->writeback = depth;
+    }
+    else if (strncmp(argv[i], "--durability=", 13) == 0)
+    {
+      /* validate optional swap durability mode */
+      DURABILITY durability = get_durability(argv[i] + 13, &(args->syncperiod));
+      if (durability == INVALID_DURABILITY)
+      {
+        fprintf(stderr, "[ERROR] --durability can only have none, end, periodic:N (N > 0) or every-evict\n");
+        return false;
+      }
+      args->durability = durability;
+    }
+    else if (strncmp(argv[i], "--swapio=", 9) == 0)
+    {
+      /* validate optional swap I/O backend */
+      SWAPIO swapio = get_swapio(argv[i] + 9);
+      if (swapio == INVALID_SWAPIO)
+      {
+        fprintf(stderr, "[ERROR] --swapio can only have mmap, pread, direct or uring\n");
+        return false;
+      }
+      args->swapio = swapio;
+    }
+    else if (strncmp(argv[i], "--readahead=", 12) == 0)
+    {
+      /* validate optional read-ahead window */
+      int window = atoi(argv[i] + 12);
+      if (window < 0 || window > PAGES)
+      {
+        fprintf(stderr, "[ERROR] --readahead can only have a value between 0 and %d\n", PAGES);
+        return false;
+      }
+      args->readahead = window;
+    }
+    else if (strncmp(argv[i], "--markov=", 9) == 0)
+    {
+      /* validate optional correlation prefetcher degree and table size */
+      int degree = atoi(argv[i] + 9);
+      char *tablesize = strchr(argv[i] + 9, ':');
+      if (degree < 0 || degree > MARKOV_SUCCESSORS)
+      {
+        fprintf(stderr, "[ERROR] --markov degree can only have a value between 0 and %d\n", MARKOV_SUCCESSORS);
+        return false;
+      }
+      if (tablesize != NULL)
+      {
+        args->markovtablesize = atoi(tablesize + 1);
+        if (args->markovtablesize < 1 || args->markovtablesize > PAGES)
+        {
+          fprintf(stderr, "[ERROR] --markov table size can only have a value between 1 and %d\n", PAGES);
+          return false;
+        }
+      }
+      args->markovdegree = degree;
+    }
+    else if (strncmp(argv[i], "--zswap=", 8) == 0)
+    {
+      /* validate optional compressed pool budget */
+      int budget = atoi(argv[i] + 8);
+      if (budget < 0 || budget > PAGES * PAGESIZE)
+      {
+        fprintf(stderr, "[ERROR] --zswap can only have a value between 0 and %d\n", PAGES * PAGESIZE);
+        return false;
+      }
+      args->zswap = budget;
+    }
+    else if (strncmp(argv[i], "--standby=", 10) == 0)
+    {
+      /* validate optional standby reserve, against -f once every arg is parsed */
+      int reserve = atoi(argv[i] + 10);
+      if (reserve < 0)
+      {
+        fprintf(stderr, "[ERROR] --standby can only have a value of 0 or more\n");
+        return false;
+      }
+      args->standby = reserve;
+    }
+    else if (strncmp(argv[i], "--swaplayout=", 13) == 0)
+    {
+      /* validate optional swap layout */
+      SWAPLAYOUT swaplayout = get_swaplayout(argv[i] + 13);
+      if (swaplayout == INVALID_SWAPLAYOUT)
+      {
+        fprintf(stderr, "[ERROR] --swaplayout can only have fixed, log or compact\n");
+        return false;
+      }
+      args->swaplayout = swaplayout;
+    }
+    else if (strncmp(argv[i], "--swapdev=", 10) == 0)
+    {
+      /* validate optional additional swap device */
+      if (args->swapdevcount == MAX_SWAPDEVICES - 1)
+      {
+        fprintf(stderr, "[ERROR] --swapdev can be given at most %d times\n", MAX_SWAPDEVICES - 1);
+        return false;
+      }
+      int priority, slots, pathstart = 0;
+      if (sscanf(argv[i] + 10, "%d:%d:%n", &priority, &slots, &pathstart) != 2 || pathstart == 0)
+      {
+        fprintf(stderr, "[ERROR] --swapdev expects <priority>:<slots>:<path>\n");
+        return false;
+      }
+      const char *path = argv[i] + 10 + pathstart;
+      if (slots < 1 || slots > PAGES || strlen(path) == 0 || strlen(path) >= 64)
+      {
+        fprintf(stderr, "[ERROR] --swapdev slots can only have a value between 1 and %d and path must be 1 to 63 characters\n", PAGES);
+        return false;
+      }
+      swapdevarg *dev = args->swapdevs + args->swapdevcount;
+      dev->path = (char *)malloc(strlen(path) + 1);
+      strcpy(dev->path, path);
+      dev->priority = priority;
+      dev->slots = slots;
+      args->swapdevcount++;
+    }
+    else if (strncmp(argv[i], "--dirtygran=", 12) == 0)
+    {
+      /* validate optional sub-page dirty tracking granularity */
+      int granularity = get_dirtygranularity(argv[i] + 12);
+      if (granularity == -1)
+      {
+        fprintf(stderr, "[ERROR] --dirtygran can only have byte, word or line\n");
+        return false;
+      }
+      args->dirtygranularity = granularity;
+    }
+    else if (strcmp(argv[i], "--elidesilent") == 0)
+    {
+      args->elidesilent = true;
+    }
+    else if (strncmp(argv[i], "--ksm=", 6) == 0)
+    {
+      /* validate optional same-page merging scan rate */
+      int pages = atoi(argv[i] + 6);
+      if (pages < 0 || pages > 128)
+      {
+        fprintf(stderr, "[ERROR] --ksm can only have a value between 0 and 128\n");
+        return false;
+      }
+      args->ksm = pages;
+    }
+    else if (strncmp(argv[i], "--watermarks=", 13) == 0)
+    {
+      /* validate optional background reclaim watermarks, against -f once every arg is parsed */
+      if (sscanf(argv[i] + 13, "%d:%d", &(args->lowwatermark), &(args->highwatermark)) != 2)
+      {
+        fprintf(stderr, "[ERROR] --watermarks expects <low>:<high>\n");
+        return false;
+      }
+    }
+    else if (strncmp(argv[i], "--generations=", 14) == 0)
+    {
+      /* validate optional number of MGLRU generations */
+      int generations = atoi(argv[i] + 14);
+      if (generations < MGLRU_MIN_GENERATIONS || generations > MGLRU_MAX_GENERATIONS)
+      {
+        fprintf(stderr, "[ERROR] --generations can only have a value between %d and %d\n", MGLRU_MIN_GENERATIONS, MGLRU_MAX_GENERATIONS);
+        return false;
+      }
+      args->generations = generations;
+    }
+    else if (strncmp(argv[i], "--agebits=", 10) == 0)
+    {
+      /* validate optional AGING counter width */
+      int agebits = atoi(argv[i] + 10);
+      if (agebits < AGING_MIN_BITS || agebits > AGING_MAX_BITS)
+      {
+        fprintf(stderr, "[ERROR] --agebits can only have a value between %d and %d\n", AGING_MIN_BITS, AGING_MAX_BITS);
+        return false;
+      }
+      args->agebits = agebits;
+    }
+    else if (strncmp(argv[i], "--tau=", 6) == 0)
+    {
+      /* validate optional WSCLOCK working-set window */
+      int tau = atoi(argv[i] + 6);
+      if (tau < 1 || tau > WSCLOCK_MAX_TAU)
+      {
+        fprintf(stderr, "[ERROR] --tau can only have a value between 1 and %d\n", WSCLOCK_MAX_TAU);
+        return false;
+      }
+      args->tau = tau;
+    }
+    else if (strncmp(argv[i], "--pff=", 6) == 0)
+    {
+      /* validate optional PFF fault rate thresholds */
+      if (sscanf(argv[i] + 6, "%lf:%lf", &(args->pfflow), &(args->pffhigh)) != 2 ||
+          args->pfflow < 0 || args->pffhigh <= args->pfflow || args->pffhigh > 100)
+      {
+        fprintf(stderr, "[ERROR] --pff expects <low>:<high> with 0 <= low < high <= 100\n");
+        return false;
+      }
+    }
+    else if (strncmp(argv[i], "--pffwindow=", 12) == 0)
+    {
+      /* validate optional PFF window */
+      int window = atoi(argv[i] + 12);
+      if (window < 1 || window > PFF_MAX_WINDOW)
+      {
+        fprintf(stderr, "[ERROR] --pffwindow can only have a value between 1 and %d\n", PFF_MAX_WINDOW);
+        return false;
+      }
+      args->pffwindow = window;
+    }
+    else if (strncmp(argv[i], "--pffmin=", 9) == 0)
+    {
+      /* validate optional PFF frame floor, against -f once every arg is parsed */
+      args->pffmin = atoi(argv[i] + 9);
     } /* else ignore invalid args */
   }
 
+  if (args->swapdevcount > 0 && args->swaplayout == SWAPLAYOUT_LOG)
+  {
+    fprintf(stderr, "[ERROR] --swapdev cannot be combined with --swaplayout=log\n");
+    return false;
+  }
+  if (args->swapdevcount > 0 && args->swaplayout == SWAPLAYOUT_FIXED)
+  {
+    // pages only move between devices through slots handed out on demand
+    printf("[INFO] --swapdev uses the compact swap layout\n");
+    args->swaplayout = SWAPLAYOUT_COMPACT;
+  }
+
   if (!(validation & HAS_LEVEL))
   {
     fprintf(stderr, "[ERROR] missing -p <level> value\n");
@@ -300,5 +832,32 @@ bool init_cmdargs(cmd_args *args, const int argc, const char *argv[])
     return false;
   }
 
+  // checks across options, the values they compare against are all set
+  if ((args->lowwatermark != 0 || args->highwatermark != 0) &&
+      (args->lowwatermark < 1 || args->highwatermark < args->lowwatermark || args->highwatermark >= args->fcount))
+  {
+    fprintf(stderr, "[ERROR] --watermarks needs 1 <= low <= high < fcount\n");
+    return false;
+  }
+
+  if (args->standby >= args->fcount || (args->pffhigh > 0 && args->standby >= args->pffmin))
+  {
+    // the standby frames come out of the frames a trace gets, one has to be left for resident pages
+    fprintf(stderr, "[ERROR] --standby needs frames < fcount, and < pffmin with --pff\n");
+    return false;
+  }
+
+  if (args->pffhigh > 0 && (args->pffmin < 4 || args->pffmin > args->fcount))
+  {
+    fprintf(stderr, "[ERROR] --pffmin needs 4 <= frames <= fcount\n");
+    return false;
+  }
+  if (args->pffhigh > 0 && args->lowwatermark > 0)
+  {
+    // background reclaim keeps free frames the allotment does not have
+    fprintf(stderr, "[ERROR] --pff cannot be combined with --watermarks\n");
+    return false;
+  }
+
   return true;
 }
\ No newline at end of file
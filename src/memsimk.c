@@ -5,6 +5,12 @@
 #include <string.h>
 
 #include "memsimk.h"
+#include "writeback.h"
+#include "prefetch.h"
+#include "zpool.h"
+#include "swaplog.h"
+#include "swapalloc.h"
+#include "swapdevs.h"
 
 void write_log(
     memsim *simulator,
@@ -57,16 +63,18 @@ bool str_to_uint8(const char *str, uint8_t *res)
   return true;
 }
 
-memsim *new_memsim(
-    int level,
-    int fcount,
-    char *swapfile,
-    char *outfile,
-    ALGO algo)
+memsim *new_memsim(const cmd_args *args)
 {
+  int level = args->level;
+  int fcount = args->fcount;
   memsim *simulator = (memsim *)malloc(sizeof(memsim));
 
-  newswapspace newss = new_swapspace(swapfile);
+  newswapspace newss = new_swapspace(args->swapfile, args->swapio, args->swaplayout);
+  if (newss.ss == NULL)
+  {
+    free(simulator);
+    return NULL;
+  }
   if (newss.isnew)
   {
     if (validate_newswapspace(newss.ss))
@@ -86,11 +94,43 @@ memsim *new_memsim(
     simulator->ss = newss.ss;
   }
 
-  simulator->outfile = fopen(outfile, "w");
+  for (int i = 0; i < args->swapdevcount; i++)
+  {
+    const swapdevarg *dev = args->swapdevs + i;
+    if (!add_swapdevice(simulator->ss, dev->path, dev->priority, dev->slots, args->swapio))
+    {
+      fprintf(stderr, "[ERROR] failed to add swap device %s\n", dev->path);
+      free_swapspace(&(simulator->ss));
+      free(simulator);
+      return NULL;
+    }
+  }
+
+  simulator->ss->durability = args->durability;
+  simulator->syncperiod = args->syncperiod;
+  simulator->pf = new_prefetcher(args->readahead, args->markovdegree, args->markovtablesize);
+  simulator->sb = args->standby > 0 ? new_standby(args->standby, fcount) : NULL;
+  simulator->sp = args->dirtygranularity > 0 ? new_subpage(args->dirtygranularity, fcount) : NULL;
+  simulator->fh = args->elidesilent ? new_framehash(fcount) : NULL;
+  simulator->ksm = args->ksm > 0 ? new_ksm(args->ksm, fcount) : NULL;
+  simulator->kswapd = args->lowwatermark > 0 ? new_kswapd(args->lowwatermark, args->highwatermark) : NULL;
+  simulator->pff = args->pffhigh > 0 ? new_pff(args->pffwindow, args->pfflow, args->pffhigh, args->pffmin, fcount) : NULL;
+  if (args->writeback > 0)
+  {
+    // dirty evictions are handed to the writeback thread from now on
+    simulator->ss->wb = new_writeback(simulator->ss, args->writeback);
+  }
+  if (args->zswap > 0)
+  {
+    // evicted pages are compressed into memory first, swap only sees the overflow
+    simulator->ss->zp = new_zpool(args->zswap);
+  }
+
+  simulator->outfile = fopen(args->outfile, "w");
   if (simulator->outfile == NULL)
   {
     fprintf(stderr, "[ERROR] failed to open outfile for write\n");
-    free_swapspace(&(newss.ss));
+    free_swapspace(&(simulator->ss));
     free(simulator);
     return NULL;
   }
@@ -111,44 +151,44 @@ memsim *new_memsim(
   // initialize memory to fcount and all frames zeroed out
   simulator->framecount = fcount;
   simulator->memory = (page *)malloc(sizeof(page) * fcount);
-  simulator->currmemorysize = 0;
+  simulator->references = 0;
+  simulator->pagefaults = 0;
+  simulator->zerofillfaults = 0;
+  simulator->zerofills = 0;
+  simulator->standbyfaults = 0;
+  simulator->shutdownflushed = 0;
+  simulator->frames = new_framepool(fcount, simulator->sb);
+  if (simulator->pff != NULL)
+  {
+    // frames beyond the first allotment are held back until the fault rate asks for them
+    for (int i = simulator->pff->allotted; i < fcount; i++)
+    {
+      hold_frame(simulator->frames);
+    }
+  }
+  simulator->dirtyframes = (uint64_t *)calloc(FRAME_BITMAP_WORDS(fcount), sizeof(uint64_t));
   for (int i = 0; i < fcount; i++)
   {
     simulator->memory[i] = new_page();
   }
 
-  simulator->pagereplaceralgo = algo;
-  switch (algo)
-  {
-  case FIFO:
-    simulator->pagereplacer = (void *)new_fifo(
-        simulator->type,
-        simulator->vpt,
-        fcount);
-    break;
-  case CLOCK:
-    simulator->pagereplacer = (void *)new_sclock(
-        simulator->type,
-        simulator->vpt,
-        fcount);
-    break;
-  case ECLOCK:
-    simulator->pagereplacer = (void *)new_eclock(
-        simulator->type,
-        simulator->vpt,
-        fcount);
-    break;
-  case LRU:
-    simulator->pagereplacer = (void *)new_lru(
-        simulator->type,
-        simulator->vpt,
-        fcount);
-    break;
-  default:
-    fprintf(stderr, "[ERROR] invalid algorithm type: %d\n", algo);
-    free_swapspace(&(newss.ss));
+  // built-in policies and policy modules alike, a module that fails to load has reported why
+  simulator->pagereplacer = new_replacer(args, simulator->type, simulator->vpt);
+  if (simulator->pagereplacer == NULL)
+  {
+    fclose(simulator->outfile);
+    free_swapspace(&(simulator->ss));
     free(simulator->vpt);
     free(simulator->memory);
+    free_framepool(simulator->frames);
+    free(simulator->dirtyframes);
+    free_prefetcher(simulator->pf);
+    free_standby(simulator->sb);
+    free_subpage(simulator->sp);
+    free_framehash(simulator->fh);
+    free_ksm(simulator->ksm);
+    free_kswapd(simulator->kswapd);
+    free_pff(simulator->pff);
     free(simulator);
     return NULL;
   }
@@ -171,22 +211,19 @@ void free_memsim(memsim *simulator)
       }
     }
     free_swapspace(&(simulator->ss));
+    fclose(simulator->outfile);
     free(simulator->vpt);
     free(simulator->memory);
-    switch (simulator->pagereplaceralgo)
-    {
-    case FIFO:
-      free_fifo((fifo *)simulator->pagereplacer);
-      break;
-    case CLOCK:
-      free_sclock((sclock *)simulator->pagereplacer);
-      break;
-    case ECLOCK:
-      free_eclock((eclock *)simulator->pagereplacer);
-      break;
-    case LRU:
-      free_lru((lru *)simulator->pagereplacer);
-    }
+    free_framepool(simulator->frames);
+    free(simulator->dirtyframes);
+    free_prefetcher(simulator->pf);
+    free_standby(simulator->sb);
+    free_subpage(simulator->sp);
+    free_framehash(simulator->fh);
+    free_ksm(simulator->ksm);
+    free_kswapd(simulator->kswapd);
+    free_pff(simulator->pff);
+    free_replacer(simulator->pagereplacer);
     free(simulator);
   }
 }
@@ -210,12 +247,279 @@ void reset_references(memsim *simulator)
       {
         continue;
       }
-      uint16_t virtualaddr = i << 6;
-      unset_referencedpte(TWO_LEVEL, simulator->vpt, virtualaddr);
+      // every entry of the inner table, the outer index is the top 5 bits of the address
+      for (uint16_t j = 0; j < 32; j++)
+      {
+        uint16_t virtualaddr = (i << 11) | (j << 6);
+        unset_referencedpte(TWO_LEVEL, simulator->vpt, virtualaddr);
+      }
+    }
+  }
+}
+
+// loadpage: brings the page holding virtualaddr into memory and keeps the per-frame bookkeeping in sync
+struct pagefaultresult loadpage(memsim *simulator, uint16_t virtualaddr, bool ismodified, uint8_t value)
+{
+  struct pagefaultresult result = handlepagefault(
+      simulator->pagereplacer,
+      virtualaddr,
+      simulator->memory,
+      simulator->frames,
+      simulator->ss,
+      simulator->sb,
+      simulator->sp,
+      simulator->fh,
+      ismodified,
+      value);
+
+  if (result.zerofilled)
+  {
+    simulator->zerofills++;
+  }
+  if (simulator->kswapd != NULL)
+  {
+    kswapd_onfault(simulator->kswapd, result.evictions);
+  }
+  if (result.evictions > 0 && simulator->pf != NULL)
+  {
+    prefetch_onevict(simulator->pf, result.evictedVA >> 6);
+  }
+
+  // any previous occupant of the frame has been written back on eviction
+  if (ismodified)
+  {
+    SET_FRAME_BIT(simulator->dirtyframes, result.PFN);
+  }
+  else
+  {
+    UNSET_FRAME_BIT(simulator->dirtyframes, result.PFN);
+  }
+  if (simulator->sp != NULL)
+  {
+    subpage_clear(simulator->sp, result.PFN);
+    if (ismodified)
+      subpage_mark(simulator->sp, result.PFN, virtualaddr & 0x003f);
+  }
+  return result;
+}
+
+// prefetch: pages in whatever the prefetch engines expect to be accessed after virtualaddr
+// prefetched pages are left unreferenced so that they are the first to go if they are not used
+void prefetch(memsim *simulator, uint16_t virtualaddr)
+{
+  prefetchcandidate candidates[PAGES];
+  // never let a single access turn over more than half of the frames allotted
+  int allotted = simulator->frames->framecount - simulator->frames->nheld;
+  int count = prefetch_candidates(simulator->pf, virtualaddr >> 6, candidates, allotted / 2);
+  for (int i = 0; i < count; i++)
+  {
+    uint16_t prefetchaddr = candidates[i].vpn << 6;
+    if (isvalid_pte(simulator->type, simulator->vpt, prefetchaddr))
+    {
+      continue;
+    }
+    loadpage(simulator, prefetchaddr, false, 0);
+    unset_referencedpte(simulator->type, simulator->vpt, prefetchaddr);
+    prefetch_onissue(simulator->pf, candidates[i].vpn, candidates[i].source);
+  }
+}
+
+// pagein: resolves a demand page fault on virtualaddr, returns the frame the page was loaded into
+uint16_t pagein(memsim *simulator, uint16_t virtualaddr, bool ismodified, uint8_t value)
+{
+  simulator->pagefaults++;
+  struct pagefaultresult result = loadpage(simulator, virtualaddr, ismodified, value);
+  if (result.zerofilled)
+  {
+    simulator->zerofillfaults++;
+  }
+  else if (result.fromstandby)
+  {
+    simulator->standbyfaults++;
+  }
+  if (ismodified && simulator->fh == NULL)
+  {
+    // the page is dirty from the start, whatever swap holds for it is stale
+    // unless silent stores are elided, the write may leave the page as swap has it
+    discard_swapcopy(simulator->ss, virtualaddr >> 6);
+  }
+  if (simulator->pf != NULL)
+  {
+    prefetch(simulator, virtualaddr);
+  }
+  return result.PFN;
+}
+
+// notereference: bookkeeping for every reference, resident or not, before it is resolved
+void notereference(memsim *simulator, uint16_t virtualaddr)
+{
+  replacer_onreference(simulator->pagereplacer, virtualaddr);
+}
+
+// pagehit: bookkeeping for a reference to a resident page
+void pagehit(memsim *simulator, uint16_t virtualaddr)
+{
+  replacer_onhit(simulator->pagereplacer, virtualaddr);
+  // the first use of a prefetched page keeps its stream going
+  if (simulator->pf != NULL && prefetch_onhit(simulator->pf, virtualaddr >> 6))
+  {
+    prefetch(simulator, virtualaddr);
+  }
+}
+
+int flush_dirtyframes(memsim *simulator)
+{
+  int flushed = 0;
+  for (int w = 0; w < FRAME_BITMAP_WORDS(simulator->framecount); w++)
+  {
+    uint64_t word = simulator->dirtyframes[w];
+    while (word != 0)
+    {
+      int frame = (w << 6) + __builtin_ctzll(word);
+      word &= word - 1;
+      if (simulator->frames->sharers[frame] == 0)
+      {
+        // evicted by background reclaim and written back then, the frame was not reused since
+        continue;
+      }
+      // a dirty frame is never shared, it holds a single page
+      uint16_t virtualaddr = simulator->frames->firstpage[frame] << 6;
+      if (!ismodified_pte(simulator->type, simulator->vpt, virtualaddr))
+      {
+        // cleaned while resident, swap is already current
+        continue;
+      }
+      if (simulator->fh != NULL && framehash_unchanged(simulator->fh, frame, simulator->memory + frame))
+      {
+        unset_modifiedpte(simulator->type, simulator->vpt, virtualaddr);
+        continue;
+      }
+      if (simulator->sp != NULL)
+        subpage_writeback(simulator->sp, simulator->ss, (virtualaddr & 0xffc0) >> 6, frame, simulator->memory + frame);
+      else
+        write_page(simulator->ss, (virtualaddr & 0xffc0) >> 6, simulator->memory + frame);
+      unset_modifiedpte(simulator->type, simulator->vpt, virtualaddr);
+      flushed++;
+    }
+    simulator->dirtyframes[w] = 0;
+  }
+  return flushed;
+}
+
+// background_reclaim: evicts a batch of pages once free frames drop below the low watermark
+// runs between two references, the faults that follow find their frames free
+void background_reclaim(memsim *simulator)
+{
+  kswapd *kd = simulator->kswapd;
+  if (!kswapd_shouldwake(kd, simulator->frames->nfree))
+  {
+    return;
+  }
+  int evictions = 0;
+  while (simulator->frames->nfree < kd->high)
+  {
+    struct reclaimresult reclaimed = reclaimframes(
+        simulator->pagereplacer,
+        simulator->memory,
+        simulator->frames,
+        simulator->ss,
+        simulator->sb,
+        simulator->sp,
+        simulator->fh,
+        simulator->frames->nfree + 1);
+    if (reclaimed.evictions == 0)
+    {
+      break;
+    }
+    evictions += reclaimed.evictions;
+    if (simulator->pf != NULL)
+    {
+      prefetch_onevict(simulator->pf, reclaimed.evictedVA >> 6);
+    }
+  }
+  kswapd_onreclaim(kd, evictions);
+}
+
+// resize_allotment: gives the trace the frames PFF allots it
+// held frames come back free, frames are held back free ones first, resident pages are evicted for the rest
+void resize_allotment(memsim *simulator, const int allotted)
+{
+  framepool *frames = simulator->frames;
+  while (frames->framecount - frames->nheld < allotted)
+  {
+    release_frame(frames);
+  }
+  while (frames->framecount - frames->nheld > allotted)
+  {
+    if (frames->nfree == 0)
+    {
+      struct reclaimresult reclaimed = reclaimframes(
+          simulator->pagereplacer,
+          simulator->memory,
+          frames,
+          simulator->ss,
+          simulator->sb,
+          simulator->sp,
+          simulator->fh,
+          1);
+      if (reclaimed.evictions == 0)
+      {
+        break;
+      }
+      if (simulator->pf != NULL)
+      {
+        prefetch_onevict(simulator->pf, reclaimed.evictedVA >> 6);
+      }
     }
+    hold_frame(frames);
   }
 }
 
+// cowbreak: gives the page at virtualaddr a private copy of the merged frame it is about to write
+// returns false if the page itself was evicted to make room, the write then faults it back in
+bool cowbreak(memsim *simulator, uint16_t virtualaddr)
+{
+  struct reclaimresult reclaimed = reclaimframes(
+      simulator->pagereplacer,
+      simulator->memory,
+      simulator->frames,
+      simulator->ss,
+      simulator->sb,
+      simulator->sp,
+      simulator->fh,
+      1);
+  if (reclaimed.evictions > 0 && simulator->pf != NULL)
+  {
+    prefetch_onevict(simulator->pf, reclaimed.evictedVA >> 6);
+  }
+  if (!isvalid_pte(simulator->type, simulator->vpt, virtualaddr))
+  {
+    return false;
+  }
+  uint16_t shared = get_framenumber(simulator->type, simulator->vpt, virtualaddr);
+  if (simulator->frames->sharers[shared] == 1)
+  {
+    // every other page of the frame was evicted while making room
+    return true;
+  }
+  uint16_t vpn = virtualaddr >> 6;
+  uint16_t frame = acquire_frame(simulator->frames);
+  memcpy(simulator->memory + frame, simulator->memory + shared, sizeof(page));
+  unmap_frame(simulator->frames, shared, vpn);
+  map_frame(simulator->frames, frame, vpn);
+  update_framenumber(simulator->type, simulator->vpt, virtualaddr, frame);
+  if (simulator->fh != NULL)
+  {
+    framehash_onload(simulator->fh, frame, simulator->memory + frame);
+  }
+  if (simulator->sp != NULL)
+  {
+    subpage_clear(simulator->sp, frame);
+  }
+  simulator->ksm->stats.cowbreaks++;
+  return true;
+}
+
 void read_source(memsim *simulator, const char *inputfile, const int tick)
 {
 
@@ -232,7 +536,7 @@ void read_source(memsim *simulator, const char *inputfile, const int tick)
   char *token = NULL; /* 'w' for write or 'r' for read */
 
   int memoryreferences = 0;
-  int pagefaults = 0;
+  int totalreferences = 0;
   while ((read = getline(&line, &len, infile)) != -1)
   {
     token = strtok(line, " ");
@@ -255,31 +559,31 @@ void read_source(memsim *simulator, const char *inputfile, const int tick)
         break;
       }
 
-      if (isvalid_pte(simulator->type, simulator->vpt, virtualaddr))
+      notereference(simulator, virtualaddr);
+
+      bool resident = isvalid_pte(simulator->type, simulator->vpt, virtualaddr);
+      if (resident && simulator->ksm != NULL &&
+          simulator->frames->sharers[get_framenumber(simulator->type, simulator->vpt, virtualaddr)] > 1)
+      {
+        // merged frames are read only
+        resident = cowbreak(simulator, virtualaddr);
+      }
+      if (resident)
       {
         set_referencedpte(simulator->type, simulator->vpt, virtualaddr);
         set_modifiedpte(simulator->type, simulator->vpt, virtualaddr);
         uint16_t framenumber = get_framenumber(simulator->type, simulator->vpt, virtualaddr);
         writetopage(simulator->memory + framenumber, virtualaddr, value);
+        SET_FRAME_BIT(simulator->dirtyframes, framenumber);
+        if (simulator->sp != NULL)
+          subpage_mark(simulator->sp, framenumber, virtualaddr & 0x003f);
         write_log(simulator, virtualaddr, framenumber, false);
-        if (simulator->pagereplaceralgo == LRU)
-        {
-          update_referencedtime((lru *)simulator->pagereplacer, virtualaddr);
-        }
+        pagehit(simulator, virtualaddr);
       }
       else
       {
-        pagefaults++;
-        struct pagefaultresult result = handlepagefault(
-            simulator->pagereplaceralgo,
-            simulator->pagereplacer,
-            virtualaddr,
-            simulator->memory,
-            &(simulator->currmemorysize),
-            simulator->ss,
-            true,
-            value);
-        write_log(simulator, virtualaddr, result.PFN, true);
+        uint16_t framenumber = pagein(simulator, virtualaddr, true, value);
+        write_log(simulator, virtualaddr, framenumber, true);
       }
     }
     else if (strcmp(token, "r") == 0)
@@ -293,30 +597,20 @@ void read_source(memsim *simulator, const char *inputfile, const int tick)
         break;
       }
 
+      notereference(simulator, virtualaddr);
+
       // if the page is valid, simply set its reference bit
       if (isvalid_pte(simulator->type, simulator->vpt, virtualaddr))
       {
         set_referencedpte(simulator->type, simulator->vpt, virtualaddr);
         uint16_t framenumber = get_framenumber(simulator->type, simulator->vpt, virtualaddr);
         write_log(simulator, virtualaddr, framenumber, false);
-        if (simulator->pagereplaceralgo == LRU)
-        {
-          update_referencedtime((lru *)simulator->pagereplacer, virtualaddr);
-        }
+        pagehit(simulator, virtualaddr);
       }
       else
       {
-        pagefaults++;
-        struct pagefaultresult result = handlepagefault(
-            simulator->pagereplaceralgo,
-            simulator->pagereplacer,
-            virtualaddr,
-            simulator->memory,
-            &(simulator->currmemorysize),
-            simulator->ss,
-            false,
-            0);
-        write_log(simulator, virtualaddr, result.PFN, true);
+        uint16_t framenumber = pagein(simulator, virtualaddr, false, 0);
+        write_log(simulator, virtualaddr, framenumber, true);
       }
     }
     else
@@ -326,15 +620,110 @@ void read_source(memsim *simulator, const char *inputfile, const int tick)
       break;
     }
 
+    if (simulator->kswapd != NULL)
+    {
+      background_reclaim(simulator);
+    }
+    if (simulator->pff != NULL)
+    {
+      resize_allotment(simulator, pff_onreference(simulator->pff, simulator->pagefaults));
+    }
+
+    simulator->references++;
     memoryreferences++;
     if (memoryreferences == tick)
     {
       memoryreferences = 0;
+      // tick-driven policies run before the referenced bits of the tick that just ended are reset
+      replacer_ontick(simulator->pagereplacer);
       reset_references(simulator);
+      if (simulator->ksm != NULL)
+      {
+        ksm_scan(simulator->ksm, simulator->frames, simulator->memory, simulator->dirtyframes, simulator->type, simulator->vpt);
+      }
+    }
+
+    totalreferences++;
+    if (simulator->ss->durability == DURABILITY_PERIODIC && totalreferences % simulator->syncperiod == 0)
+    {
+      sync_swapspace(simulator->ss, 0, PAGES);
     }
   }
   free(line);
   fclose(infile);
-  fprintf(simulator->outfile, "%d", pagefaults);
+
+  // graceful shutdown, dirty frames still in memory go back to the swapspace
+  // the final sync happens when the swapspace is freed
+  simulator->shutdownflushed = flush_dirtyframes(simulator);
+
+  fprintf(simulator->outfile, "%d", simulator->pagefaults);
   fflush(simulator->outfile);
 }
+
+void print_summary(memsim *simulator)
+{
+  printf("page faults (%s): %d (major: %d, minor zero-fill: %d, minor standby: %d)\n",
+         simulator->pagereplacer->policy->name,
+         simulator->pagefaults,
+         simulator->pagefaults - simulator->zerofillfaults - simulator->standbyfaults,
+         simulator->zerofillfaults,
+         simulator->standbyfaults);
+  printf("page fault rate: %.2f%% of %d references with %d frames\n",
+         simulator->references ? 100.0 * simulator->pagefaults / simulator->references : 0.0,
+         simulator->references,
+         simulator->framecount);
+  printf("swap reads saved by zero-fill: %d\n", simulator->zerofills);
+  printf("dirty frames flushed at shutdown: %d\n", simulator->shutdownflushed);
+  print_replacerstats(simulator->pagereplacer);
+  if (simulator->sb != NULL)
+  {
+    print_standbystats(simulator->sb);
+  }
+  if (simulator->sp != NULL)
+  {
+    print_subpagestats(simulator->sp);
+  }
+  if (simulator->fh != NULL)
+  {
+    print_framehashstats(simulator->fh);
+  }
+  if (simulator->ksm != NULL)
+  {
+    print_ksmstats(simulator->ksm, simulator->frames);
+  }
+  if (simulator->kswapd != NULL)
+  {
+    print_kswapdstats(simulator->kswapd);
+  }
+  if (simulator->pff != NULL)
+  {
+    print_pffstats(simulator->pff);
+  }
+  if (simulator->pf != NULL)
+  {
+    print_prefetchstats(simulator->pf, simulator->pagefaults);
+  }
+  if (simulator->ss->wb != NULL)
+  {
+    print_writebackstats(simulator->ss->wb);
+  }
+  if (simulator->ss->zp != NULL)
+  {
+    print_zpoolstats(simulator->ss->zp, &(simulator->ss->iostats));
+  }
+  if (simulator->ss->log != NULL)
+  {
+    print_swaplogstats(simulator->ss->log);
+  }
+  if (simulator->ss->devs != NULL)
+  {
+    print_swapdevsstats(simulator->ss->devs);
+  }
+  else if (simulator->ss->alloc != NULL)
+  {
+    print_swapallocstats(simulator->ss->alloc);
+  }
+  print_swapiostats(simulator->ss);
+  // syncs still issued on teardown are not included
+  printf("swap syncs: %lu\n", atomic_load(&(simulator->ss->syncs)));
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "nextuse.h"
+
+// hexdigits: value of each hex digit character, -1 for any other character
+// a table lookup keeps the digit loop free of data dependent branches
+static signed char hexdigits[256];
+
+static void init_hexdigits(void)
+{
+  memset(hexdigits, -1, sizeof(hexdigits));
+  for (int i = 0; i < 10; i++)
+    hexdigits['0' + i] = i;
+  for (int i = 0; i < 6; i++)
+  {
+    hexdigits['a' + i] = 10 + i;
+    hexdigits['A' + i] = 10 + i;
+  }
+}
+
+// scan_trace: parses the page of every reference into vpns, returns the number of references
+// stops at the first line read_source would reject, the simulation stops there as well
+static uint32_t scan_trace(const char *p, const char *end, uint16_t *vpns)
+{
+  uint32_t count = 0;
+  init_hexdigits();
+  while (p < end)
+  {
+    if ((*p != 'r' && *p != 'w') || p + 1 == end || p[1] != ' ')
+    {
+      break;
+    }
+    p += 2;
+    while (p < end && *p == ' ')
+      p++;
+    if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+      p += 2;
+    uint32_t va = 0;
+    int digit;
+    while (p < end && (digit = hexdigits[(unsigned char)*p]) != -1)
+    {
+      va = (va << 4) | digit;
+      p++;
+    }
+    vpns[count++] = (uint16_t)va >> 6;
+    // the written value is left to read_source
+    while (p < end && *p != '\n')
+      p++;
+    p++;
+  }
+  return count;
+}
+
+nextuse *new_nextuse(const char *addrfile)
+{
+  nextuse *nu = (nextuse *)malloc(sizeof(nextuse));
+  nu->count = 0;
+  nu->next = NULL;
+  for (int i = 0; i < PAGES; i++)
+  {
+    nu->first[i] = NEXTUSE_NEVER;
+  }
+
+  int fd = open(addrfile, O_RDONLY);
+  if (fd == -1)
+  {
+    perror("new_nextuse");
+    return nu;
+  }
+  struct stat sb;
+  if (fstat(fd, &sb) == -1 || sb.st_size == 0)
+  {
+    close(fd);
+    return nu;
+  }
+  const char *trace = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (trace == MAP_FAILED)
+  {
+    perror("new_nextuse");
+    return nu;
+  }
+  madvise((void *)trace, sb.st_size, MADV_SEQUENTIAL);
+
+  // the shortest reference line is "r 0\n", the last one may lack its newline
+  uint16_t *vpns = (uint16_t *)malloc(sizeof(uint16_t) * (sb.st_size / 4 + 1));
+  nu->count = scan_trace(trace, trace + sb.st_size, vpns);
+  munmap((void *)trace, sb.st_size);
+
+  // walking backwards, first holds the closest later reference of each page
+  nu->next = (uint32_t *)malloc(sizeof(uint32_t) * (nu->count > 0 ? nu->count : 1));
+  for (uint32_t i = nu->count; i-- > 0;)
+  {
+    nu->next[i] = nu->first[vpns[i]];
+    nu->first[vpns[i]] = i;
+  }
+  free(vpns);
+  return nu;
+}
+
+void free_nextuse(nextuse *nu)
+{
+  if (nu)
+  {
+    free(nu->next);
+    free(nu);
+  }
+}
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pff.h"
+
+// sample_window: records the frames allotted during the window that just ended and its fault rate
+static void sample_window(pff *pf, double rate)
+{
+  pffstats *stats = &(pf->stats);
+  if ((pf->windows - 1) % stats->stride != 0)
+  {
+    return;
+  }
+  if (stats->nsamples == PFF_SAMPLES)
+  {
+    // keep every other sample, the run so far is covered at half the rate
+    for (int i = 0; i < PFF_SAMPLES / 2; i++)
+    {
+      stats->frames[i] = stats->frames[2 * i];
+      stats->rates[i] = stats->rates[2 * i];
+    }
+    stats->nsamples = PFF_SAMPLES / 2;
+    stats->stride *= 2;
+    if ((pf->windows - 1) % stats->stride != 0)
+    {
+      return;
+    }
+  }
+  stats->frames[stats->nsamples] = pf->allotted;
+  stats->rates[stats->nsamples] = rate;
+  stats->nsamples++;
+}
+
+pff *new_pff(int window, double low, double high, int minframes, int maxframes)
+{
+  pff *pf = (pff *)malloc(sizeof(pff));
+  pf->window = window;
+  pf->low = low;
+  pf->high = high;
+  pf->minframes = minframes;
+  pf->maxframes = maxframes;
+  pf->allotted = minframes;
+  pf->references = 0;
+  pf->windowstart = 0;
+  pf->windows = 0;
+  memset(&(pf->stats), 0, sizeof(pffstats));
+  pf->stats.stride = 1;
+  pf->stats.maxallotted = minframes;
+  return pf;
+}
+
+void free_pff(pff *pf)
+{
+  free(pf);
+}
+
+// pff_onreference: counts a reference, pagefaults is the number of faults so far
+// returns the frames allotted from now on, a new allotment only at the end of a window
+int pff_onreference(pff *pf, const int pagefaults)
+{
+  pf->stats.framesum += pf->allotted;
+  pf->references++;
+  if (pf->references < pf->window)
+  {
+    return pf->allotted;
+  }
+
+  double rate = 100.0 * (pagefaults - pf->windowstart) / pf->references;
+  pf->references = 0;
+  pf->windowstart = pagefaults;
+  pf->windows++;
+  int allotted = pf->allotted;
+  if (rate > pf->high)
+  {
+    allotted += allotted / 4 > 1 ? allotted / 4 : 1;
+    if (allotted > pf->maxframes)
+      allotted = pf->maxframes;
+  }
+  else if (rate < pf->low)
+  {
+    allotted -= allotted / 8 > 1 ? allotted / 8 : 1;
+    if (allotted < pf->minframes)
+      allotted = pf->minframes;
+  }
+  sample_window(pf, rate);
+  if (allotted > pf->allotted)
+    pf->stats.grows++;
+  else if (allotted < pf->allotted)
+    pf->stats.shrinks++;
+  pf->allotted = allotted;
+  if (allotted > pf->stats.maxallotted)
+    pf->stats.maxallotted = allotted;
+  return allotted;
+}
+
+void print_pffstats(const pff *pf)
+{
+  const pffstats *stats = &(pf->stats);
+  unsigned long references = pf->windows * pf->window + pf->references;
+  printf("pff thresholds: grow above %.2f%%, shrink below %.2f%% of %d references, %d to %d frames\n",
+         pf->high,
+         pf->low,
+         pf->window,
+         pf->minframes,
+         pf->maxframes);
+  printf("pff frames: avg %.2f, max %d, %lu grows and %lu shrinks in %lu windows\n",
+         references ? (double)stats->framesum / references : 0.0,
+         stats->maxallotted,
+         stats->grows,
+         stats->shrinks,
+         pf->windows);
+  printf("pff frames every %lu references:", stats->stride * pf->window);
+  for (int i = 0; i < stats->nsamples; i++)
+  {
+    printf(" %d", stats->frames[i]);
+  }
+  printf("\n");
+  printf("pff fault rate every %lu references:", stats->stride * pf->window);
+  for (int i = 0; i < stats->nsamples; i++)
+  {
+    printf(" %.1f%%", stats->rates[i]);
+  }
+  printf("\n");
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+
+#include "policy.h"
+
+// load_module: opens the policy module at path and looks its policy up
+// returns NULL if the module cannot be opened or lacks the hooks every policy needs
+static const replacementpolicy *load_module(const char *path, void **module)
+{
+  *module = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (*module == NULL)
+  {
+    fprintf(stderr, "[ERROR] failed to load policy module: %s\n", dlerror());
+    return NULL;
+  }
+  const replacementpolicy *policy = (const replacementpolicy *)dlsym(*module, POLICY_SYMBOL);
+  if (policy == NULL || policy->name == NULL || policy->create == NULL ||
+      policy->choose_victim == NULL || policy->on_load == NULL)
+  {
+    fprintf(stderr, "[ERROR] %s does not export a policy with create, choose_victim and on_load as %s\n", path, POLICY_SYMBOL);
+    dlclose(*module);
+    *module = NULL;
+    return NULL;
+  }
+  return policy;
+}
+
+replacer *new_replacer(const cmd_args *args, PAGETABLE type, void *vpt)
+{
+  replacer *rp = (replacer *)malloc(sizeof(replacer));
+  rp->type = type;
+  rp->vpt = vpt;
+  rp->module = NULL;
+  if (args->algo == PLUGIN)
+  {
+    rp->policy = load_module(args->pluginpath, &(rp->module));
+  }
+  else
+  {
+    rp->policy = get_policy(args->algo);
+    if (rp->policy == NULL)
+      fprintf(stderr, "[ERROR] invalid algorithm type: %d\n", args->algo);
+  }
+  if (rp->policy == NULL)
+  {
+    free(rp);
+    return NULL;
+  }
+  rp->state = rp->policy->create(type, vpt, args->fcount, args);
+  if (rp->state == NULL)
+  {
+    fprintf(stderr, "[ERROR] policy %s failed to start\n", rp->policy->name);
+    if (rp->module != NULL)
+      dlclose(rp->module);
+    free(rp);
+    return NULL;
+  }
+  return rp;
+}
+
+void free_replacer(replacer *rp)
+{
+  if (rp)
+  {
+    if (rp->policy->destroy != NULL)
+      rp->policy->destroy(rp->state);
+    // the hooks live in the module, it goes last
+    if (rp->module != NULL)
+      dlclose(rp->module);
+    free(rp);
+  }
+}
+
+void replacer_onreference(replacer *rp, uint16_t virtualaddr)
+{
+  if (rp->policy->on_reference != NULL)
+    rp->policy->on_reference(rp->state, virtualaddr);
+}
+
+void replacer_onhit(replacer *rp, uint16_t virtualaddr)
+{
+  if (rp->policy->on_hit != NULL)
+    rp->policy->on_hit(rp->state, virtualaddr);
+}
+
+void replacer_onfault(replacer *rp, uint16_t virtualaddr)
+{
+  if (rp->policy->on_fault != NULL)
+    rp->policy->on_fault(rp->state, virtualaddr);
+}
+
+int replacer_choosevictim(replacer *rp)
+{
+  return rp->policy->choose_victim(rp->state);
+}
+
+void replacer_onload(replacer *rp, uint16_t virtualaddr, pagetableentry *pte)
+{
+  rp->policy->on_load(rp->state, virtualaddr, pte);
+}
+
+void replacer_onevict(replacer *rp, uint16_t virtualaddr)
+{
+  if (rp->policy->on_evict != NULL)
+    rp->policy->on_evict(rp->state, virtualaddr);
+}
+
+void replacer_ontick(replacer *rp)
+{
+  if (rp->policy->on_tick != NULL)
+    rp->policy->on_tick(rp->state);
+}
+
+int replacer_writebacks(replacer *rp, uint16_t *pages)
+{
+  if (rp->policy->writebacks == NULL)
+    return 0;
+  return rp->policy->writebacks(rp->state, pages);
+}
+
+void print_replacerstats(const replacer *rp)
+{
+  if (rp->policy->print_stats != NULL)
+    rp->policy->print_stats(rp->state);
+}
@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prefetch.h"
+
+readahead *new_readahead(int maxwindow)
+{
+  readahead *ra = (readahead *)malloc(sizeof(readahead));
+  ra->maxwindow = maxwindow;
+  ra->window = maxwindow < READAHEAD_INITIAL_WINDOW ? maxwindow : READAHEAD_INITIAL_WINDOW;
+  ra->lastvpn = -1;
+  ra->stride = 0;
+  ra->streak = 0;
+  ra->frontier = -1;
+  return ra;
+}
+
+// readahead_candidates: feeds vpn to the stream detector and
+// lists the pages of the window that were not prefetched yet
+int readahead_candidates(readahead *ra, const uint16_t vpn, prefetchcandidate *candidates, const int max)
+{
+  int stride = ra->lastvpn == -1 ? 0 : (int)vpn - ra->lastvpn;
+  if (stride != 0 && stride == ra->stride)
+  {
+    ra->streak++;
+  }
+  else
+  {
+    // a new stream starts, pages prefetched for the old one are left alone
+    ra->stride = stride;
+    ra->streak = 0;
+    ra->frontier = -1;
+  }
+  ra->lastvpn = vpn;
+
+  if (ra->streak == 0)
+  {
+    return 0;
+  }
+
+  // continue from the frontier if the stream is already ahead of this access
+  int next = (int)vpn + ra->stride;
+  if (ra->frontier != -1 && (ra->stride > 0 ? ra->frontier >= next : ra->frontier <= next))
+  {
+    next = ra->frontier + ra->stride;
+  }
+  int end = (int)vpn + ra->stride * ra->window;
+
+  int count = 0;
+  while (count < max && (ra->stride > 0 ? next <= end : next >= end) && next >= 0 && next < PAGES)
+  {
+    candidates[count].vpn = (uint16_t)next;
+    candidates[count].source = PREFETCH_READAHEAD;
+    count++;
+    ra->frontier = next;
+    next += ra->stride;
+  }
+  return count;
+}
+
+markov *new_markov(int degree, int tablesize)
+{
+  markov *mk = (markov *)malloc(sizeof(markov));
+  mk->degree = degree;
+  mk->tablesize = tablesize;
+  mk->table = (markoventry *)malloc(sizeof(markoventry) * tablesize);
+  for (int i = 0; i < tablesize; i++)
+  {
+    mk->table[i].vpn = -1;
+  }
+  for (int i = 0; i < PAGES; i++)
+  {
+    mk->entryof[i] = -1;
+  }
+  mk->nextvictim = 0;
+  mk->lastvpn = -1;
+  mk->lookups = 0;
+  mk->predictions = 0;
+  return mk;
+}
+
+void free_markov(markov *mk)
+{
+  if (mk)
+  {
+    free(mk->table);
+    free(mk);
+  }
+}
+
+// markov_entry: returns the table entry of vpn, recycling one if vpn is not tracked yet
+markoventry *markov_entry(markov *mk, const uint16_t vpn)
+{
+  if (mk->entryof[vpn] != -1)
+  {
+    return mk->table + mk->entryof[vpn];
+  }
+  markoventry *entry = mk->table + mk->nextvictim;
+  if (entry->vpn != -1)
+  {
+    mk->entryof[entry->vpn] = -1;
+  }
+  entry->vpn = vpn;
+  memset(entry->counts, 0, sizeof(entry->counts));
+  mk->entryof[vpn] = mk->nextvictim;
+  mk->nextvictim = (mk->nextvictim + 1) % mk->tablesize;
+  return entry;
+}
+
+// markov_record: counts successor as having followed the entry's page,
+// the least observed successor makes room for a new one
+void markov_record(markoventry *entry, const uint16_t successor)
+{
+  int slot = -1;
+  int weakest = 0;
+  for (int i = 0; i < MARKOV_SUCCESSORS; i++)
+  {
+    if (entry->counts[i] != 0 && entry->successors[i] == successor)
+    {
+      slot = i;
+      break;
+    }
+    if (entry->counts[i] < entry->counts[weakest])
+    {
+      weakest = i;
+    }
+  }
+  if (slot == -1)
+  {
+    slot = weakest;
+    entry->successors[slot] = successor;
+    entry->counts[slot] = 0;
+  }
+
+  if (entry->counts[slot] == MARKOV_MAX_COUNT)
+  {
+    // age the entry so that it follows changes in the fault stream
+    for (int i = 0; i < MARKOV_SUCCESSORS; i++)
+    {
+      entry->counts[i] /= 2;
+    }
+  }
+  entry->counts[slot]++;
+}
+
+// markov_candidates: learns the transition into vpn and lists its most likely successors
+int markov_candidates(markov *mk, const uint16_t vpn, prefetchcandidate *candidates, const int max)
+{
+  if (mk->lastvpn != -1 && mk->lastvpn != vpn)
+  {
+    markov_record(markov_entry(mk, mk->lastvpn), vpn);
+  }
+  mk->lastvpn = vpn;
+
+  mk->lookups++;
+  if (mk->entryof[vpn] == -1)
+  {
+    return 0;
+  }
+  markoventry *entry = mk->table + mk->entryof[vpn];
+
+  // pick the successors by decreasing count, at most degree of them
+  bool taken[MARKOV_SUCCESSORS] = {false};
+  int count = 0;
+  while (count < max && count < mk->degree)
+  {
+    int best = -1;
+    for (int i = 0; i < MARKOV_SUCCESSORS; i++)
+    {
+      if (!taken[i] && entry->counts[i] != 0 && (best == -1 || entry->counts[i] > entry->counts[best]))
+      {
+        best = i;
+      }
+    }
+    if (best == -1)
+    {
+      break;
+    }
+    taken[best] = true;
+    candidates[count].vpn = entry->successors[best];
+    candidates[count].source = PREFETCH_MARKOV;
+    count++;
+  }
+  if (count > 0)
+  {
+    mk->predictions++;
+  }
+  return count;
+}
+
+prefetcher *new_prefetcher(int readaheadwindow, int markovdegree, int markovtablesize)
+{
+  if (readaheadwindow <= 0 && markovdegree <= 0)
+  {
+    return NULL;
+  }
+  prefetcher *pf = (prefetcher *)malloc(sizeof(prefetcher));
+  memset(pf->prefetched, PREFETCH_NONE, sizeof(pf->prefetched));
+  memset(pf->stats, 0, sizeof(pf->stats));
+  pf->ra = readaheadwindow > 0 ? new_readahead(readaheadwindow) : NULL;
+  pf->mk = markovdegree > 0 ? new_markov(markovdegree, markovtablesize) : NULL;
+  return pf;
+}
+
+void free_prefetcher(prefetcher *pf)
+{
+  if (pf)
+  {
+    free(pf->ra);
+    free_markov(pf->mk);
+    free(pf);
+  }
+}
+
+int prefetch_candidates(prefetcher *pf, const uint16_t vpn, prefetchcandidate *candidates, const int max)
+{
+  int count = 0;
+  if (pf->ra != NULL)
+  {
+    count += readahead_candidates(pf->ra, vpn, candidates + count, max - count);
+  }
+  if (pf->mk != NULL)
+  {
+    count += markov_candidates(pf->mk, vpn, candidates + count, max - count);
+  }
+  return count;
+}
+
+bool prefetch_onhit(prefetcher *pf, const uint16_t vpn)
+{
+  PREFETCHSOURCE source = pf->prefetched[vpn];
+  if (source == PREFETCH_NONE)
+  {
+    return false;
+  }
+  pf->prefetched[vpn] = PREFETCH_NONE;
+  pf->stats[source].used++;
+  if (source == PREFETCH_READAHEAD && pf->ra->window < pf->ra->maxwindow)
+  {
+    pf->ra->window = pf->ra->window * 2 > pf->ra->maxwindow ? pf->ra->maxwindow : pf->ra->window * 2;
+  }
+  return true;
+}
+
+void prefetch_onissue(prefetcher *pf, const uint16_t vpn, PREFETCHSOURCE source)
+{
+  pf->prefetched[vpn] = source;
+  pf->stats[source].issued++;
+}
+
+void prefetch_onevict(prefetcher *pf, const uint16_t vpn)
+{
+  PREFETCHSOURCE source = pf->prefetched[vpn];
+  if (source == PREFETCH_NONE)
+  {
+    return;
+  }
+  pf->prefetched[vpn] = PREFETCH_NONE;
+  pf->stats[source].wasted++;
+  if (source == PREFETCH_READAHEAD && pf->ra->window > 1)
+  {
+    pf->ra->window /= 2;
+  }
+}
+
+// wouldbefaults: demand faults the trace would have taken without any prefetching
+static void print_enginestats(const char *name, const prefetchstats *stats, unsigned long wouldbefaults)
+{
+  printf("%s prefetch issued: %lu, used: %lu, wasted: %lu, unused at exit: %lu\n",
+         name,
+         stats->issued,
+         stats->used,
+         stats->wasted,
+         stats->unused);
+  // accuracy: share of prefetches that were used
+  // coverage: share of would-be demand faults that prefetching removed
+  printf("%s prefetch accuracy: %.2f%%, coverage: %.2f%%\n",
+         name,
+         stats->issued ? 100.0 * stats->used / stats->issued : 0.0,
+         wouldbefaults ? 100.0 * stats->used / wouldbefaults : 0.0);
+}
+
+void print_prefetchstats(prefetcher *pf, int demandfaults)
+{
+  // whatever was never referenced by the end of the trace did not help either
+  prefetchstats total = {0};
+  for (int i = 0; i < PAGES; i++)
+  {
+    if (pf->prefetched[i] != PREFETCH_NONE)
+      pf->stats[pf->prefetched[i]].unused++;
+  }
+  for (int source = PREFETCH_READAHEAD; source < PREFETCH_SOURCES; source++)
+  {
+    total.issued += pf->stats[source].issued;
+    total.used += pf->stats[source].used;
+    total.wasted += pf->stats[source].wasted;
+    total.unused += pf->stats[source].unused;
+  }
+  unsigned long wouldbefaults = demandfaults + total.used;
+
+  if (pf->ra != NULL)
+  {
+    printf("readahead window: %d (max %d)\n", pf->ra->window, pf->ra->maxwindow);
+    print_enginestats("readahead", pf->stats + PREFETCH_READAHEAD, wouldbefaults);
+  }
+  if (pf->mk != NULL)
+  {
+    printf("markov degree: %d, table: %d entries, lookups: %lu, predicted: %lu\n",
+           pf->mk->degree,
+           pf->mk->tablesize,
+           pf->mk->lookups,
+           pf->mk->predictions);
+    print_enginestats("markov", pf->stats + PREFETCH_MARKOV, wouldbefaults);
+  }
+  if (pf->ra != NULL && pf->mk != NULL)
+  {
+    print_enginestats("total", &total, wouldbefaults);
+  }
+  printf("demand faults: %d, avoided by prefetch: %lu\n", demandfaults, total.used);
+}
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "standby.h"
+
+standby *new_standby(int reserve, int framecount)
+{
+  standby *sb = (standby *)malloc(sizeof(standby));
+  sb->reserve = reserve;
+  sb->framecount = framecount;
+  sb->pageof = (int *)malloc(sizeof(int) * framecount);
+  sb->prev = (int *)malloc(sizeof(int) * framecount);
+  sb->next = (int *)malloc(sizeof(int) * framecount);
+  for (int i = 0; i < framecount; i++)
+  {
+    sb->pageof[i] = -1;
+    sb->prev[i] = -1;
+    sb->next[i] = -1;
+  }
+  for (int i = 0; i < PAGES; i++)
+  {
+    sb->frameof[i] = -1;
+  }
+  sb->oldest = -1;
+  sb->newest = -1;
+  memset(&(sb->stats), 0, sizeof(standbystats));
+  return sb;
+}
+
+void free_standby(standby *sb)
+{
+  if (sb)
+  {
+    free(sb->pageof);
+    free(sb->prev);
+    free(sb->next);
+    free(sb);
+  }
+}
+
+// standby_unlink: takes frame out of the eviction order, its contents no longer count as a page on standby
+static void standby_unlink(standby *sb, int frame)
+{
+  if (sb->prev[frame] != -1)
+    sb->next[sb->prev[frame]] = sb->next[frame];
+  else
+    sb->oldest = sb->next[frame];
+  if (sb->next[frame] != -1)
+    sb->prev[sb->next[frame]] = sb->prev[frame];
+  else
+    sb->newest = sb->prev[frame];
+
+  sb->frameof[sb->pageof[frame]] = -1;
+  sb->pageof[frame] = -1;
+  sb->prev[frame] = -1;
+  sb->next[frame] = -1;
+}
+
+// standby_insert: vpn was evicted from frame, which is free from now on and still holds its contents
+void standby_insert(standby *sb, const uint16_t vpn, const uint16_t frame)
+{
+  sb->pageof[frame] = vpn;
+  sb->frameof[vpn] = frame;
+  sb->prev[frame] = sb->newest;
+  sb->next[frame] = -1;
+  if (sb->newest != -1)
+    sb->next[sb->newest] = frame;
+  else
+    sb->oldest = frame;
+  sb->newest = frame;
+  sb->stats.inserted++;
+}
+
+// standby_reclaim: returns the free frame still holding vpn, -1 if its frame was acquired again since its eviction
+// the caller takes that frame off the free frames, the page is resident there again
+int standby_reclaim(standby *sb, const uint16_t vpn)
+{
+  int frame = sb->frameof[vpn];
+  if (frame == -1)
+  {
+    return -1;
+  }
+  standby_unlink(sb, frame);
+  sb->stats.reclaimed++;
+  return frame;
+}
+
+// standby_repurpose: frame is acquired for another use, whatever page it still held loses its contents
+void standby_repurpose(standby *sb, const uint16_t frame)
+{
+  if (sb->pageof[frame] == -1)
+  {
+    return;
+  }
+  standby_unlink(sb, frame);
+  sb->stats.repurposed++;
+}
+
+void print_standbystats(const standby *sb)
+{
+  const standbystats *stats = &(sb->stats);
+  printf("standby frames: %d of %d kept free for evicted pages, %d left for resident pages\n",
+         sb->reserve,
+         sb->framecount,
+         sb->framecount - sb->reserve);
+  printf("standby pages inserted: %lu, reclaimed: %lu, repurposed: %lu\n",
+         stats->inserted,
+         stats->reclaimed,
+         stats->repurposed);
+  printf("standby reclaim rate: %.2f%%\n",
+         stats->inserted ? 100.0 * stats->reclaimed / stats->inserted : 0.0);
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "subpage.h"
+
+subpage *new_subpage(int unitsize, int framecount)
+{
+  subpage *sp = (subpage *)malloc(sizeof(subpage));
+  sp->unitsize = unitsize;
+  sp->framecount = framecount;
+  sp->dirty = (uint64_t *)calloc(framecount, sizeof(uint64_t));
+  memset(&(sp->stats), 0, sizeof(subpagestats));
+  return sp;
+}
+
+void free_subpage(subpage *sp)
+{
+  if (sp)
+  {
+    free(sp->dirty);
+    free(sp);
+  }
+}
+
+void subpage_clear(subpage *sp, const uint16_t frame)
+{
+  sp->dirty[frame] = 0;
+}
+
+void subpage_mark(subpage *sp, const uint16_t frame, const uint16_t offset)
+{
+  sp->dirty[frame] |= (uint64_t)1 << (offset / sp->unitsize);
+}
+
+// subpage_writeback: writes back the dirty units of frame, one write per contiguous run of them
+bool subpage_writeback(subpage *sp, swapspace *ss, const uint16_t idx, const uint16_t frame, const page *pg)
+{
+  uint64_t dirty = sp->dirty[frame];
+  sp->dirty[frame] = 0;
+  sp->stats.writebacks++;
+  if (dirty == 0 || !can_writeranges(ss))
+  {
+    sp->stats.fullpages++;
+    sp->stats.ranges++;
+    sp->stats.byteswritten += PAGESIZE;
+    return write_page(ss, idx, pg);
+  }
+
+  bool ok = true;
+  while (dirty != 0)
+  {
+    int first = __builtin_ctzll(dirty);
+    // ones starting at first, the run ends at the next clean unit
+    uint64_t run = dirty >> first;
+    int units = ~run == 0 ? 64 - first : __builtin_ctzll(~run);
+    int offset = first * sp->unitsize;
+    int length = units * sp->unitsize;
+    ok = write_range(ss, idx, offset, length, pg) && ok;
+    sp->stats.ranges++;
+    sp->stats.byteswritten += length;
+    dirty &= units + first == 64 ? 0 : ~(uint64_t)0 << (first + units);
+  }
+  if (ss->durability == DURABILITY_EVERY_EVICT)
+  {
+    ok = sync_swapspace(ss, idx, 1) && ok;
+  }
+  return ok;
+}
+
+void print_subpagestats(const subpage *sp)
+{
+  const subpagestats *stats = &(sp->stats);
+  unsigned long fullpagebytes = stats->writebacks * PAGESIZE;
+  printf("subpage dirty granularity: %d bytes\n", sp->unitsize);
+  printf("subpage writebacks: %lu pages, %lu ranges, %lu written as full pages\n",
+         stats->writebacks,
+         stats->ranges,
+         stats->fullpages);
+  printf("subpage bytes written: %lu vs %lu with full-page writeback (%.2f%% saved)\n",
+         stats->byteswritten,
+         fullpagebytes,
+         fullpagebytes ? 100.0 * (fullpagebytes - stats->byteswritten) / fullpagebytes : 0.0);
+}
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "swapalloc.h"
+#include "swapbackend.h"
+#include "compress.h"
+
+// release_slot: gives the slot of vpn back, called with the lock held
+static void release_slot(swapalloc *sa, const uint16_t vpn)
+{
+  int slot = sa->slotof[vpn];
+  if (slot == -1)
+  {
+    return;
+  }
+  sa->inuse[slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+  sa->slotof[vpn] = -1;
+  sa->used--;
+  sa->stats.freed++;
+}
+
+// allocate_slot: hands out the lowest free slot, growing the file if every slot is taken
+// called with the lock held, returns -1 if the file cannot grow
+static int allocate_slot(swapalloc *sa)
+{
+  int slot = -1;
+  for (int w = 0; w < SWAPALLOC_BITMAP_WORDS && slot == -1; w++)
+  {
+    if (~sa->inuse[w] != 0)
+    {
+      slot = w * 64 + __builtin_ctzll(~sa->inuse[w]);
+    }
+  }
+  if (slot == -1 || slot >= sa->capacity)
+  {
+    return -1;
+  }
+  if (slot >= sa->ss->nslots)
+  {
+    int nslots = sa->ss->nslots + SWAPALLOC_CHUNK_SLOTS;
+    if (!resize_backingstore(sa->ss, nslots > PAGES ? PAGES : nslots))
+    {
+      return -1;
+    }
+    sa->stats.grows++;
+  }
+
+  sa->inuse[slot >> 6] |= (uint64_t)1 << (slot & 63);
+  sa->used++;
+  if (sa->used > sa->stats.peakslots)
+    sa->stats.peakslots = sa->used;
+  sa->stats.allocated++;
+  if (slot < sa->highwater)
+    sa->stats.reused++;
+  else
+    sa->highwater = slot + 1;
+  return slot;
+}
+
+swapalloc *new_swapalloc(swapspace *ss)
+{
+  swapalloc *sa = (swapalloc *)malloc(sizeof(swapalloc));
+  sa->ss = ss;
+  memset(sa->inuse, 0, sizeof(sa->inuse));
+  sa->capacity = PAGES;
+  sa->used = 0;
+  sa->highwater = 0;
+  memset(&(sa->stats), 0, sizeof(swapallocstats));
+  // pages with data start out in their fixed slot, if the file has one for them
+  for (int i = 0; i < PAGES; i++)
+  {
+    sa->slotof[i] = -1;
+    if (has_backingdata(ss, i) && i < ss->nslots)
+    {
+      sa->slotof[i] = i;
+      sa->inuse[i >> 6] |= (uint64_t)1 << (i & 63);
+      sa->used++;
+      sa->highwater = i + 1;
+    }
+  }
+  sa->stats.peakslots = sa->used;
+  pthread_mutex_init(&(sa->lock), NULL);
+  return sa;
+}
+
+void free_swapalloc(swapalloc *sa)
+{
+  if (sa)
+  {
+    pthread_mutex_destroy(&(sa->lock));
+    free(sa);
+  }
+}
+
+void swapalloc_reset(swapalloc *sa, int capacity)
+{
+  pthread_mutex_lock(&(sa->lock));
+  memset(sa->inuse, 0, sizeof(sa->inuse));
+  for (int i = 0; i < PAGES; i++)
+  {
+    sa->slotof[i] = -1;
+  }
+  sa->capacity = capacity;
+  sa->used = 0;
+  sa->highwater = 0;
+  memset(&(sa->stats), 0, sizeof(swapallocstats));
+  pthread_mutex_unlock(&(sa->lock));
+}
+
+bool swapalloc_full(swapalloc *sa)
+{
+  pthread_mutex_lock(&(sa->lock));
+  bool full = sa->used >= sa->capacity;
+  pthread_mutex_unlock(&(sa->lock));
+  return full;
+}
+
+bool swapalloc_holds(swapalloc *sa, const uint16_t vpn)
+{
+  pthread_mutex_lock(&(sa->lock));
+  bool holds = sa->slotof[vpn] != -1;
+  pthread_mutex_unlock(&(sa->lock));
+  return holds;
+}
+
+bool swapalloc_store(swapalloc *sa, const uint16_t vpn, const page *pages[], const int n)
+{
+  bool ok = true;
+  pthread_mutex_lock(&(sa->lock));
+  for (int i = 0; i < n; i++)
+  {
+    uint8_t fill;
+    if (is_samefilled(pages[i], &fill) && fill == 0)
+    {
+      // an all zero page needs no slot, it reads back as zeros without one
+      release_slot(sa, vpn + i);
+      continue;
+    }
+    if (sa->slotof[vpn + i] == -1)
+    {
+      sa->slotof[vpn + i] = allocate_slot(sa);
+      if (sa->slotof[vpn + i] == -1)
+      {
+        fprintf(stderr, "[ERROR] swapalloc_store: no slot for page %d\n", vpn + i);
+        ok = false;
+        continue;
+      }
+    }
+    ok = write_slots(sa->ss, sa->slotof[vpn + i], pages + i, 1) && ok;
+  }
+  pthread_mutex_unlock(&(sa->lock));
+  return ok;
+}
+
+bool swapalloc_read(swapalloc *sa, const uint16_t vpn, page *pg)
+{
+  pthread_mutex_lock(&(sa->lock));
+  bool ok = true;
+  if (sa->slotof[vpn] == -1)
+  {
+    *pg = new_page();
+  }
+  else
+  {
+    ok = read_slot(sa->ss, sa->slotof[vpn], pg);
+  }
+  pthread_mutex_unlock(&(sa->lock));
+  return ok;
+}
+
+bool swapalloc_sync(swapalloc *sa)
+{
+  // the file may be growing, the mapping must not move under the sync
+  pthread_mutex_lock(&(sa->lock));
+  bool ok = sa->ss->backend->sync(sa->ss, 0, sa->ss->nslots);
+  pthread_mutex_unlock(&(sa->lock));
+  return ok;
+}
+
+void swapalloc_discard(swapalloc *sa, const uint16_t vpn)
+{
+  pthread_mutex_lock(&(sa->lock));
+  release_slot(sa, vpn);
+  pthread_mutex_unlock(&(sa->lock));
+}
+
+void print_swapallocstats(swapalloc *sa)
+{
+  pthread_mutex_lock(&(sa->lock));
+  const swapallocstats *stats = &(sa->stats);
+  printf("swap slots: %d in use, peak %d, file %d slots (%zu bytes, fixed layout %zu bytes)\n",
+         sa->used,
+         stats->peakslots,
+         sa->ss->nslots,
+         sa->ss->size,
+         (size_t)PAGES * sizeof(page));
+  printf("swap slots allocated: %lu (reused %lu), freed: %lu, file grown %lu times\n",
+         stats->allocated,
+         stats->reused,
+         stats->freed,
+         stats->grows);
+  pthread_mutex_unlock(&(sa->lock));
+}
@@ -0,0 +1,602 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "swapbackend.h"
+
+/**
+ * Shared helpers
+ */
+
+// reopen_descriptor: replaces the stdio derived (append mode) descriptor with one opened with flags
+static bool reopen_descriptor(swapspace *ss, int flags)
+{
+  errno = 0;
+  int descriptor = open(ss->filename, O_RDWR | flags);
+  if (descriptor == -1)
+  {
+    perror("reopen_descriptor");
+    return false;
+  }
+  close(ss->descriptor);
+  ss->descriptor = descriptor;
+  return true;
+}
+
+// drop_memorymap: backends other than mmap never touch the mapping set up for initialization
+static void drop_memorymap(swapspace *ss)
+{
+  if (ss->memorymap != NULL && ss->memorymap != MAP_FAILED)
+  {
+    munmap(ss->memorymap, ss->size);
+  }
+  ss->memorymap = NULL;
+}
+
+static bool sync_datasync(swapspace *ss, const uint16_t idx, const int n)
+{
+  errno = 0;
+  if (fdatasync(ss->descriptor) != 0)
+  {
+    perror("sync_datasync");
+    return false;
+  }
+  return true;
+}
+
+// resize_none: backends addressing the file through its descriptor need nothing on resize
+static bool resize_none(swapspace *ss, const size_t oldsize)
+{
+  return true;
+}
+
+/**
+ * MMAP: page cache backed shared mapping
+ */
+static bool open_mmap(swapspace *ss)
+{
+  return ss->memorymap != NULL && ss->memorymap != MAP_FAILED;
+}
+
+static bool read_mmap(swapspace *ss, const uint16_t idx, page *pg)
+{
+  memcpy(pg, ss->memorymap + idx, sizeof(page));
+  return true;
+}
+
+static bool write_mmap(swapspace *ss, const uint16_t idx, const page *pages[], const int n)
+{
+  for (int i = 0; i < n; i++)
+  {
+    memcpy(ss->memorymap + idx + i, pages[i], sizeof(page));
+  }
+  return true;
+}
+
+static bool writebytes_mmap(swapspace *ss, const uint16_t idx, const int offset, const uint8_t *data, const int length)
+{
+  memcpy(ss->memorymap[idx].content + offset, data, length);
+  return true;
+}
+
+static bool sync_mmap(swapspace *ss, const uint16_t idx, const int n)
+{
+  // msync requires a system page aligned address
+  size_t pagesz = (size_t)sysconf(_SC_PAGESIZE);
+  size_t start = (size_t)idx * sizeof(page);
+  size_t end = start + (size_t)n * sizeof(page);
+  start -= start % pagesz;
+  errno = 0;
+  if (msync((char *)ss->memorymap + start, end - start, MS_SYNC) != 0)
+  {
+    perror("sync_mmap");
+    return false;
+  }
+  return true;
+}
+
+static bool resize_mmap(swapspace *ss, const size_t oldsize)
+{
+  if (ss->memorymap != NULL && ss->memorymap != MAP_FAILED)
+  {
+    munmap(ss->memorymap, oldsize);
+  }
+  errno = 0;
+  ss->memorymap = mmap(NULL, ss->size, PROT_READ | PROT_WRITE, MAP_SHARED, ss->descriptor, 0);
+  if (ss->memorymap == MAP_FAILED)
+  {
+    perror("resize_mmap");
+    return false;
+  }
+  return true;
+}
+
+static void close_mmap(swapspace *ss)
+{
+  drop_memorymap(ss);
+}
+
+/**
+ * PREAD: buffered system calls, one pwritev per contiguous run
+ */
+static bool open_pread(swapspace *ss)
+{
+  drop_memorymap(ss);
+  return reopen_descriptor(ss, 0);
+}
+
+static bool read_pread(swapspace *ss, const uint16_t idx, page *pg)
+{
+  errno = 0;
+  if (pread(ss->descriptor, pg, sizeof(page), (off_t)idx * sizeof(page)) != sizeof(page))
+  {
+    perror("read_pread");
+    return false;
+  }
+  return true;
+}
+
+static bool write_pread(swapspace *ss, const uint16_t idx, const page *pages[], const int n)
+{
+  struct iovec iov[PAGES];
+  for (int i = 0; i < n; i++)
+  {
+    iov[i].iov_base = (void *)pages[i];
+    iov[i].iov_len = sizeof(page);
+  }
+  errno = 0;
+  if (pwritev(ss->descriptor, iov, n, (off_t)idx * sizeof(page)) != (ssize_t)(n * sizeof(page)))
+  {
+    perror("write_pread");
+    return false;
+  }
+  return true;
+}
+
+static bool writebytes_pread(swapspace *ss, const uint16_t idx, const int offset, const uint8_t *data, const int length)
+{
+  errno = 0;
+  if (pwrite(ss->descriptor, data, length, (off_t)idx * sizeof(page) + offset) != length)
+  {
+    perror("writebytes_pread");
+    return false;
+  }
+  return true;
+}
+
+static void close_pread(swapspace *ss)
+{
+}
+
+/**
+ * DIRECT: O_DIRECT bypasses the page cache, pages are smaller than a block
+ * so reads fetch the enclosing block and writes read-modify-write it
+ */
+typedef struct directstate
+{
+  pthread_mutex_t lock;
+  uint8_t *buffer; // DIRECT_ALIGNMENT aligned, as large as the backing store, reallocated when the file is resized
+} directstate;
+
+static bool open_direct(swapspace *ss)
+{
+  if (ss->size % DIRECT_ALIGNMENT != 0)
+  {
+    fprintf(stderr, "[ERROR] open_direct: swapspace size is not a multiple of %d\n", DIRECT_ALIGNMENT);
+    return false;
+  }
+  drop_memorymap(ss);
+  if (!reopen_descriptor(ss, O_DIRECT))
+  {
+    return false;
+  }
+  directstate *state = (directstate *)malloc(sizeof(directstate));
+  if (posix_memalign((void **)&(state->buffer), DIRECT_ALIGNMENT, ss->size) != 0)
+  {
+    fprintf(stderr, "[ERROR] open_direct: failed to allocate aligned buffer\n");
+    free(state);
+    return false;
+  }
+  pthread_mutex_init(&(state->lock), NULL);
+  ss->backenddata = state;
+  return true;
+}
+
+static bool read_direct(swapspace *ss, const uint16_t idx, page *pg)
+{
+  directstate *state = (directstate *)ss->backenddata;
+  size_t offset = (size_t)idx * sizeof(page);
+  size_t block = offset - offset % DIRECT_ALIGNMENT;
+  bool ok = true;
+  pthread_mutex_lock(&(state->lock));
+  errno = 0;
+  if (pread(ss->descriptor, state->buffer, DIRECT_ALIGNMENT, block) != DIRECT_ALIGNMENT)
+  {
+    perror("read_direct");
+    ok = false;
+  }
+  else
+  {
+    memcpy(pg, state->buffer + (offset - block), sizeof(page));
+  }
+  pthread_mutex_unlock(&(state->lock));
+  return ok;
+}
+
+static bool write_direct(swapspace *ss, const uint16_t idx, const page *pages[], const int n)
+{
+  directstate *state = (directstate *)ss->backenddata;
+  size_t offset = (size_t)idx * sizeof(page);
+  size_t start = offset - offset % DIRECT_ALIGNMENT;
+  size_t end = offset + (size_t)n * sizeof(page);
+  end += (DIRECT_ALIGNMENT - end % DIRECT_ALIGNMENT) % DIRECT_ALIGNMENT;
+  ssize_t length = end - start;
+  bool ok = true;
+  pthread_mutex_lock(&(state->lock));
+  errno = 0;
+  if (pread(ss->descriptor, state->buffer, length, start) != length)
+  {
+    perror("write_direct");
+    ok = false;
+  }
+  else
+  {
+    for (int i = 0; i < n; i++)
+    {
+      memcpy(state->buffer + (offset - start) + i * sizeof(page), pages[i], sizeof(page));
+    }
+    if (pwrite(ss->descriptor, state->buffer, length, start) != length)
+    {
+      perror("write_direct");
+      ok = false;
+    }
+  }
+  pthread_mutex_unlock(&(state->lock));
+  return ok;
+}
+
+static bool writebytes_direct(swapspace *ss, const uint16_t idx, const int offset, const uint8_t *data, const int length)
+{
+  // a page never straddles blocks, neither does any range within it
+  directstate *state = (directstate *)ss->backenddata;
+  size_t position = (size_t)idx * sizeof(page) + offset;
+  size_t block = position - position % DIRECT_ALIGNMENT;
+  bool ok = true;
+  pthread_mutex_lock(&(state->lock));
+  errno = 0;
+  if (pread(ss->descriptor, state->buffer, DIRECT_ALIGNMENT, block) != DIRECT_ALIGNMENT)
+  {
+    perror("writebytes_direct");
+    ok = false;
+  }
+  else
+  {
+    memcpy(state->buffer + (position - block), data, length);
+    if (pwrite(ss->descriptor, state->buffer, DIRECT_ALIGNMENT, block) != DIRECT_ALIGNMENT)
+    {
+      perror("writebytes_direct");
+      ok = false;
+    }
+  }
+  pthread_mutex_unlock(&(state->lock));
+  return ok;
+}
+
+// resize_direct: a write may cover the whole file, the buffer grows and shrinks with it
+static bool resize_direct(swapspace *ss, const size_t oldsize)
+{
+  directstate *state = (directstate *)ss->backenddata;
+  if (ss->size % DIRECT_ALIGNMENT != 0)
+  {
+    fprintf(stderr, "[ERROR] resize_direct: swapspace size is not a multiple of %d\n", DIRECT_ALIGNMENT);
+    return false;
+  }
+  uint8_t *buffer;
+  if (posix_memalign((void **)&buffer, DIRECT_ALIGNMENT, ss->size) != 0)
+  {
+    fprintf(stderr, "[ERROR] resize_direct: failed to allocate aligned buffer\n");
+    return false;
+  }
+  pthread_mutex_lock(&(state->lock));
+  free(state->buffer);
+  state->buffer = buffer;
+  pthread_mutex_unlock(&(state->lock));
+  return true;
+}
+
+static void close_direct(swapspace *ss)
+{
+  directstate *state = (directstate *)ss->backenddata;
+  if (state)
+  {
+    pthread_mutex_destroy(&(state->lock));
+    free(state->buffer);
+    free(state);
+    ss->backenddata = NULL;
+  }
+}
+
+/**
+ * URING: io_uring driven through io_uring_setup/io_uring_enter, no liburing needed
+ * every request is submitted and waited for before returning
+ */
+typedef struct uringstate
+{
+  pthread_mutex_t lock;
+  int ringfd;
+  void *sqring;
+  size_t sqringsize;
+  void *cqring;
+  size_t cqringsize;
+  struct io_uring_sqe *sqes;
+  size_t sqessize;
+  unsigned *sqtail;
+  unsigned *sqmask;
+  unsigned *sqarray;
+  unsigned *cqhead;
+  unsigned *cqtail;
+  unsigned *cqmask;
+  struct io_uring_cqe *cqes;
+} uringstate;
+
+static void unmap_uring(uringstate *state)
+{
+  if (state->sqes != NULL && state->sqes != MAP_FAILED)
+    munmap(state->sqes, state->sqessize);
+  if (state->cqring != NULL && state->cqring != MAP_FAILED && state->cqring != state->sqring)
+    munmap(state->cqring, state->cqringsize);
+  if (state->sqring != NULL && state->sqring != MAP_FAILED)
+    munmap(state->sqring, state->sqringsize);
+  if (state->ringfd >= 0)
+    close(state->ringfd);
+}
+
+static bool open_uring(swapspace *ss)
+{
+  drop_memorymap(ss);
+  if (!reopen_descriptor(ss, 0))
+  {
+    return false;
+  }
+
+  uringstate *state = (uringstate *)calloc(1, sizeof(uringstate));
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  errno = 0;
+  state->ringfd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+  if (state->ringfd < 0)
+  {
+    perror("open_uring: io_uring_setup");
+    free(state);
+    return false;
+  }
+
+  state->sqringsize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  state->cqringsize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (state->cqringsize > state->sqringsize)
+      state->sqringsize = state->cqringsize;
+    state->cqringsize = state->sqringsize;
+  }
+  state->sqring = mmap(NULL, state->sqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, state->ringfd, IORING_OFF_SQ_RING);
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    state->cqring = state->sqring;
+  }
+  else
+  {
+    state->cqring = mmap(NULL, state->cqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, state->ringfd, IORING_OFF_CQ_RING);
+  }
+  state->sqessize = params.sq_entries * sizeof(struct io_uring_sqe);
+  state->sqes = mmap(NULL, state->sqessize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, state->ringfd, IORING_OFF_SQES);
+  if (state->sqring == MAP_FAILED || state->cqring == MAP_FAILED || state->sqes == MAP_FAILED)
+  {
+    perror("open_uring: mmap");
+    unmap_uring(state);
+    free(state);
+    return false;
+  }
+
+  state->sqtail = (unsigned *)((char *)state->sqring + params.sq_off.tail);
+  state->sqmask = (unsigned *)((char *)state->sqring + params.sq_off.ring_mask);
+  state->sqarray = (unsigned *)((char *)state->sqring + params.sq_off.array);
+  state->cqhead = (unsigned *)((char *)state->cqring + params.cq_off.head);
+  state->cqtail = (unsigned *)((char *)state->cqring + params.cq_off.tail);
+  state->cqmask = (unsigned *)((char *)state->cqring + params.cq_off.ring_mask);
+  state->cqes = (struct io_uring_cqe *)((char *)state->cqring + params.cq_off.cqes);
+  pthread_mutex_init(&(state->lock), NULL);
+  ss->backenddata = state;
+  return true;
+}
+
+// submit_uring: queues a single sqe, waits for its completion and returns its result
+// expects the caller to hold the ring lock
+static int submit_uring(uringstate *state, const struct io_uring_sqe *sqe)
+{
+  unsigned tail = *(state->sqtail);
+  unsigned index = tail & *(state->sqmask);
+  state->sqes[index] = *sqe;
+  state->sqarray[index] = index;
+  __atomic_store_n(state->sqtail, tail + 1, __ATOMIC_RELEASE);
+
+  errno = 0;
+  if (syscall(__NR_io_uring_enter, state->ringfd, 1, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+  {
+    perror("submit_uring: io_uring_enter");
+    return -errno;
+  }
+
+  unsigned head = *(state->cqhead);
+  while (head == __atomic_load_n(state->cqtail, __ATOMIC_ACQUIRE))
+  {
+    // completion is posted by the time io_uring_enter returns, this is only defensive
+    syscall(__NR_io_uring_enter, state->ringfd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+  }
+  int res = state->cqes[head & *(state->cqmask)].res;
+  __atomic_store_n(state->cqhead, head + 1, __ATOMIC_RELEASE);
+  return res;
+}
+
+static bool read_uring(swapspace *ss, const uint16_t idx, page *pg)
+{
+  uringstate *state = (uringstate *)ss->backenddata;
+  struct iovec iov = {.iov_base = pg, .iov_len = sizeof(page)};
+  struct io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_READV;
+  sqe.fd = ss->descriptor;
+  sqe.addr = (unsigned long)&iov;
+  sqe.len = 1;
+  sqe.off = (unsigned long)idx * sizeof(page);
+
+  pthread_mutex_lock(&(state->lock));
+  int res = submit_uring(state, &sqe);
+  pthread_mutex_unlock(&(state->lock));
+  if (res != sizeof(page))
+  {
+    fprintf(stderr, "[ERROR] read_uring: %s\n", res < 0 ? strerror(-res) : "short read");
+    return false;
+  }
+  return true;
+}
+
+static bool write_uring(swapspace *ss, const uint16_t idx, const page *pages[], const int n)
+{
+  uringstate *state = (uringstate *)ss->backenddata;
+  struct iovec iov[PAGES];
+  for (int i = 0; i < n; i++)
+  {
+    iov[i].iov_base = (void *)pages[i];
+    iov[i].iov_len = sizeof(page);
+  }
+  struct io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_WRITEV;
+  sqe.fd = ss->descriptor;
+  sqe.addr = (unsigned long)iov;
+  sqe.len = n;
+  sqe.off = (unsigned long)idx * sizeof(page);
+
+  pthread_mutex_lock(&(state->lock));
+  int res = submit_uring(state, &sqe);
+  pthread_mutex_unlock(&(state->lock));
+  if (res != (int)(n * sizeof(page)))
+  {
+    fprintf(stderr, "[ERROR] write_uring: %s\n", res < 0 ? strerror(-res) : "short write");
+    return false;
+  }
+  return true;
+}
+
+static bool writebytes_uring(swapspace *ss, const uint16_t idx, const int offset, const uint8_t *data, const int length)
+{
+  uringstate *state = (uringstate *)ss->backenddata;
+  struct iovec iov = {.iov_base = (void *)data, .iov_len = length};
+  struct io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_WRITEV;
+  sqe.fd = ss->descriptor;
+  sqe.addr = (unsigned long)&iov;
+  sqe.len = 1;
+  sqe.off = (unsigned long)idx * sizeof(page) + offset;
+
+  pthread_mutex_lock(&(state->lock));
+  int res = submit_uring(state, &sqe);
+  pthread_mutex_unlock(&(state->lock));
+  if (res != length)
+  {
+    fprintf(stderr, "[ERROR] writebytes_uring: %s\n", res < 0 ? strerror(-res) : "short write");
+    return false;
+  }
+  return true;
+}
+
+static bool sync_uring(swapspace *ss, const uint16_t idx, const int n)
+{
+  uringstate *state = (uringstate *)ss->backenddata;
+  struct io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_FSYNC;
+  sqe.fd = ss->descriptor;
+  sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+
+  pthread_mutex_lock(&(state->lock));
+  int res = submit_uring(state, &sqe);
+  pthread_mutex_unlock(&(state->lock));
+  if (res < 0)
+  {
+    fprintf(stderr, "[ERROR] sync_uring: %s\n", strerror(-res));
+    return false;
+  }
+  return true;
+}
+
+static void close_uring(swapspace *ss)
+{
+  uringstate *state = (uringstate *)ss->backenddata;
+  if (state)
+  {
+    pthread_mutex_destroy(&(state->lock));
+    unmap_uring(state);
+    free(state);
+    ss->backenddata = NULL;
+  }
+}
+
+static const swapbackend backends[] = {
+    [SWAPIO_MMAP] = {
+        .name = "mmap",
+        .open = open_mmap,
+        .read = read_mmap,
+        .write = write_mmap,
+        .writebytes = writebytes_mmap,
+        .sync = sync_mmap,
+        .resize = resize_mmap,
+        .close = close_mmap},
+    [SWAPIO_PREAD] = {
+        .name = "pread",
+        .open = open_pread,
+        .read = read_pread,
+        .write = write_pread,
+        .writebytes = writebytes_pread,
+        .sync = sync_datasync,
+        .resize = resize_none,
+        .close = close_pread},
+    [SWAPIO_DIRECT] = {
+        .name = "direct",
+        .open = open_direct,
+        .read = read_direct,
+        .write = write_direct,
+        .writebytes = writebytes_direct,
+        .sync = sync_datasync,
+        .resize = resize_direct,
+        .close = close_direct},
+    [SWAPIO_URING] = {
+        .name = "uring",
+        .open = open_uring,
+        .read = read_uring,
+        .write = write_uring,
+        .writebytes = writebytes_uring,
+        .sync = sync_uring,
+        .resize = resize_none,
+        .close = close_uring},
+};
+
+const swapbackend *get_swapbackend(SWAPIO swapio)
+{
+  if (swapio < SWAPIO_MMAP || swapio > SWAPIO_URING)
+  {
+    return NULL;
+  }
+  return backends + swapio;
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "swapdevs.h"
+#include "swapalloc.h"
+
+bool add_swapdevice(swapspace *ss, char *filename, int priority, int slots, SWAPIO swapio)
+{
+  if (ss->alloc == NULL)
+  {
+    fprintf(stderr, "[ERROR] add_swapdevice: swap devices require the compact layout\n");
+    return false;
+  }
+  if (ss->devs == NULL)
+  {
+    // the swapspace itself is the first device, keeping whatever it already holds
+    swapdevs *devs = (swapdevs *)malloc(sizeof(swapdevs));
+    pthread_mutex_init(&(devs->lock), NULL);
+    devs->count = 1;
+    devs->devices[0].ss = ss;
+    devs->devices[0].priority = 0;
+    devs->devices[0].placed = 0;
+    devs->cursor[0] = 0;
+    for (int i = 0; i < PAGES; i++)
+    {
+      devs->deviceof[i] = swapalloc_holds(ss->alloc, i) ? 0 : -1;
+    }
+    ss->devs = devs;
+  }
+  swapdevs *devs = ss->devs;
+  if (devs->count == MAX_SWAPDEVICES)
+  {
+    fprintf(stderr, "[ERROR] add_swapdevice: at most %d swap devices\n", MAX_SWAPDEVICES);
+    return false;
+  }
+
+  newswapspace newss = new_swapspace(filename, swapio, SWAPLAYOUT_COMPACT);
+  if (newss.ss == NULL)
+  {
+    return false;
+  }
+  memset(newss.ss->backed, 0, sizeof(newss.ss->backed));
+  swapalloc_reset(newss.ss->alloc, slots);
+
+  // keep the devices sorted by priority, after the ones with the same priority
+  int position = devs->count;
+  while (position > 0 && devs->devices[position - 1].priority < priority)
+  {
+    devs->devices[position] = devs->devices[position - 1];
+    position--;
+  }
+  devs->devices[position].ss = newss.ss;
+  devs->devices[position].priority = priority;
+  devs->devices[position].placed = 0;
+  devs->count++;
+  for (int i = 0; i < PAGES; i++)
+  {
+    if (devs->deviceof[i] >= position)
+      devs->deviceof[i]++;
+  }
+  for (int i = 0; i < devs->count; i++)
+  {
+    devs->cursor[i] = i;
+  }
+  return true;
+}
+
+void free_swapdevs(swapdevs *devs, bool sync)
+{
+  if (devs)
+  {
+    for (int i = 0; i < devs->count; i++)
+    {
+      if (devs->devices[i].ss->devs == devs)
+      {
+        // the first device is the swapspace that owns the devices
+        continue;
+      }
+      if (sync)
+      {
+        swapalloc_sync(devs->devices[i].ss->alloc);
+      }
+      free_swapspace(&(devs->devices[i].ss));
+    }
+    pthread_mutex_destroy(&(devs->lock));
+    free(devs);
+  }
+}
+
+// place_page: picks the device for a page that is on none,
+// the first group from the top with room, round robin inside the group
+// called with the lock held, returns -1 if every device is full
+static int place_page(swapdevs *devs)
+{
+  int group = 0;
+  while (group < devs->count)
+  {
+    int end = group;
+    while (end < devs->count && devs->devices[end].priority == devs->devices[group].priority)
+    {
+      end++;
+    }
+    int size = end - group;
+    for (int k = 0; k < size; k++)
+    {
+      int device = group + (devs->cursor[group] - group + k) % size;
+      if (!swapalloc_full(devs->devices[device].ss->alloc))
+      {
+        devs->cursor[group] = group + (device - group + 1) % size;
+        devs->devices[device].placed++;
+        return device;
+      }
+    }
+    group = end;
+  }
+  return -1;
+}
+
+bool swapdevs_store(swapdevs *devs, const uint16_t vpn, const page *pages[], const int n)
+{
+  bool ok = true;
+  pthread_mutex_lock(&(devs->lock));
+  for (int i = 0; i < n; i++)
+  {
+    int device = devs->deviceof[vpn + i];
+    // a page whose slot was given back may no longer fit on its device
+    if (device != -1 && !swapalloc_holds(devs->devices[device].ss->alloc, vpn + i) &&
+        swapalloc_full(devs->devices[device].ss->alloc))
+    {
+      device = -1;
+    }
+    if (device == -1)
+    {
+      device = place_page(devs);
+      if (device == -1)
+      {
+        fprintf(stderr, "[ERROR] swapdevs_store: every swap device is full\n");
+        ok = false;
+        continue;
+      }
+      devs->deviceof[vpn + i] = device;
+    }
+    ok = swapalloc_store(devs->devices[device].ss->alloc, vpn + i, pages + i, 1) && ok;
+  }
+  pthread_mutex_unlock(&(devs->lock));
+  return ok;
+}
+
+bool swapdevs_read(swapdevs *devs, const uint16_t vpn, page *pg)
+{
+  pthread_mutex_lock(&(devs->lock));
+  bool ok = true;
+  int device = devs->deviceof[vpn];
+  if (device == -1)
+  {
+    *pg = new_page();
+  }
+  else
+  {
+    ok = swapalloc_read(devs->devices[device].ss->alloc, vpn, pg);
+  }
+  pthread_mutex_unlock(&(devs->lock));
+  return ok;
+}
+
+bool swapdevs_sync(swapdevs *devs)
+{
+  bool ok = true;
+  pthread_mutex_lock(&(devs->lock));
+  for (int i = 0; i < devs->count; i++)
+  {
+    ok = swapalloc_sync(devs->devices[i].ss->alloc) && ok;
+  }
+  pthread_mutex_unlock(&(devs->lock));
+  return ok;
+}
+
+void swapdevs_discard(swapdevs *devs, const uint16_t vpn)
+{
+  pthread_mutex_lock(&(devs->lock));
+  int device = devs->deviceof[vpn];
+  if (device != -1)
+  {
+    swapalloc_discard(devs->devices[device].ss->alloc, vpn);
+    devs->deviceof[vpn] = -1;
+  }
+  pthread_mutex_unlock(&(devs->lock));
+}
+
+void print_swapdevsstats(swapdevs *devs)
+{
+  pthread_mutex_lock(&(devs->lock));
+  for (int i = 0; i < devs->count; i++)
+  {
+    swapdevice *device = devs->devices + i;
+    swapalloc *sa = device->ss->alloc;
+    const swapiostats *stats = &(device->ss->iostats);
+    pthread_mutex_lock(&(sa->lock));
+    printf("swap device %d: %s, priority %d, %d of %d slots in use, %lu pages placed\n",
+           i,
+           device->ss->filename,
+           device->priority,
+           sa->used,
+           sa->capacity,
+           device->placed);
+    pthread_mutex_unlock(&(sa->lock));
+    printf("swap device %d io: %lu reads, %lu writes in %lu calls, avg %.2fus read, %.2fus per write call\n",
+           i,
+           stats->reads,
+           stats->writes,
+           stats->writecalls,
+           stats->reads ? stats->readtime / stats->reads : 0.0,
+           stats->writecalls ? stats->writetime / stats->writecalls : 0.0);
+  }
+  pthread_mutex_unlock(&(devs->lock));
+}
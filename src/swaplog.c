@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "swaplog.h"
+
+#define SEGMENT_OF(slot) ((slot) / SWAPLOG_SEGMENT_PAGES)
+
+// flush_open: writes the part of the open segment that is not in the swap file yet
+// called with the lock held
+static bool flush_open(swaplog *lg)
+{
+  if (lg->opensegment == -1 || lg->flushed == lg->fill)
+  {
+    return true;
+  }
+  const page *run[SWAPLOG_SEGMENT_PAGES];
+  int n = lg->fill - lg->flushed;
+  for (int i = 0; i < n; i++)
+  {
+    run[i] = lg->buffer + lg->flushed + i;
+  }
+  bool ok = write_slots(lg->ss, lg->opensegment * SWAPLOG_SEGMENT_PAGES + lg->flushed, run, n);
+  lg->stats.physicalwrites += n;
+  lg->stats.writecalls++;
+  lg->flushed = lg->fill;
+  return ok;
+}
+
+// open_segment: seals the open segment and opens a free one
+// evictions leave the reserve to the cleaner and wait for it instead
+// called with the lock held
+static bool open_segment(swaplog *lg, bool iscleaner)
+{
+  bool ok = flush_open(lg);
+  int reserve = iscleaner ? 0 : SWAPLOG_RESERVE;
+  if (lg->freecount <= reserve)
+  {
+    lg->stats.stalls++;
+    while (lg->freecount <= reserve)
+    {
+      pthread_cond_signal(&(lg->needclean));
+      pthread_cond_wait(&(lg->segmentfree), &(lg->lock));
+    }
+    // relocations may have opened a segment in the meantime, it is filled before another one is opened
+    if (lg->opensegment != -1 && lg->fill < SWAPLOG_SEGMENT_PAGES)
+    {
+      return ok;
+    }
+  }
+  int segment = 0;
+  while (!lg->isfree[segment])
+  {
+    segment++;
+  }
+  lg->isfree[segment] = false;
+  lg->freecount--;
+  lg->opensegment = segment;
+  lg->fill = 0;
+  lg->flushed = 0;
+  if (lg->freecount <= SWAPLOG_CLEAN_WATERMARK)
+  {
+    pthread_cond_signal(&(lg->needclean));
+  }
+  return ok;
+}
+
+// append_page: appends a single page, the old copy of the page becomes dead
+// called with the lock held
+static bool append_page(swaplog *lg, const uint16_t vpn, const page *pg, bool iscleaner)
+{
+  bool ok = true;
+  if (lg->opensegment == -1 || lg->fill == SWAPLOG_SEGMENT_PAGES)
+  {
+    ok = open_segment(lg, iscleaner);
+  }
+
+  int old = lg->slotof[vpn];
+  if (old != -1)
+  {
+    lg->ownerof[old] = -1;
+    lg->live[SEGMENT_OF(old)]--;
+  }
+
+  int slot = lg->opensegment * SWAPLOG_SEGMENT_PAGES + lg->fill;
+  memcpy(lg->buffer + lg->fill, pg, sizeof(page));
+  lg->fill++;
+  lg->ownerof[slot] = vpn;
+  lg->slotof[vpn] = slot;
+  lg->live[lg->opensegment]++;
+
+  if (lg->fill == SWAPLOG_SEGMENT_PAGES)
+  {
+    // a full segment goes out as one sequential write
+    ok = flush_open(lg) && ok;
+  }
+  return ok;
+}
+
+// read_locked: copies the newest copy of vpn, from the open segment if it has not been written yet
+// called with the lock held
+static bool read_locked(swaplog *lg, const uint16_t vpn, page *pg)
+{
+  int slot = lg->slotof[vpn];
+  if (slot == -1)
+  {
+    // never written, the page is still zero filled
+    *pg = new_page();
+    return true;
+  }
+  if (SEGMENT_OF(slot) == lg->opensegment && slot % SWAPLOG_SEGMENT_PAGES >= lg->flushed)
+  {
+    memcpy(pg, lg->buffer + slot % SWAPLOG_SEGMENT_PAGES, sizeof(page));
+    return true;
+  }
+  return read_slot(lg->ss, slot, pg);
+}
+
+// clean_segment: picks the full segment with the fewest live pages,
+// relocates them to the head of the log and frees it
+// returns false if no segment would give any space back
+// called with the lock held
+static bool clean_segment(swaplog *lg)
+{
+  int victim = -1;
+  for (int segment = 0; segment < SWAPLOG_SEGMENTS; segment++)
+  {
+    if (lg->isfree[segment] || segment == lg->opensegment)
+      continue;
+    if (victim == -1 || lg->live[segment] < lg->live[victim])
+      victim = segment;
+  }
+  if (victim == -1 || lg->live[victim] == SWAPLOG_SEGMENT_PAGES)
+  {
+    return false;
+  }
+
+  for (int slot = victim * SWAPLOG_SEGMENT_PAGES; slot < (victim + 1) * SWAPLOG_SEGMENT_PAGES; slot++)
+  {
+    int vpn = lg->ownerof[slot];
+    if (vpn == -1)
+      continue;
+    page pg;
+    if (!read_slot(lg->ss, slot, &pg))
+    {
+      fprintf(stderr, "[ERROR] swaplog cleaner: failed to read slot %d\n", slot);
+      return false;
+    }
+    append_page(lg, (uint16_t)vpn, &pg, true);
+    lg->stats.relocated++;
+  }
+
+  lg->isfree[victim] = true;
+  lg->freecount++;
+  lg->stats.cleaned++;
+  pthread_cond_broadcast(&(lg->segmentfree));
+  return true;
+}
+
+static void *cleaner_thread(void *arg)
+{
+  swaplog *lg = (swaplog *)arg;
+  pthread_mutex_lock(&(lg->lock));
+  while (!lg->stop)
+  {
+    if (lg->freecount > SWAPLOG_CLEAN_WATERMARK || !clean_segment(lg))
+    {
+      pthread_cond_wait(&(lg->needclean), &(lg->lock));
+      continue;
+    }
+    // let evictions in between two segments
+    pthread_mutex_unlock(&(lg->lock));
+    pthread_mutex_lock(&(lg->lock));
+  }
+  pthread_mutex_unlock(&(lg->lock));
+  return NULL;
+}
+
+swaplog *new_swaplog(swapspace *ss)
+{
+  swaplog *lg = (swaplog *)malloc(sizeof(swaplog));
+  lg->ss = ss;
+  for (int i = 0; i < SWAPLOG_SLOTS; i++)
+  {
+    lg->ownerof[i] = -1;
+  }
+  memset(lg->live, 0, sizeof(lg->live));
+  // pages with data start out in their fixed slot
+  for (int i = 0; i < PAGES; i++)
+  {
+    lg->slotof[i] = has_backingdata(ss, i) ? i : -1;
+    if (lg->slotof[i] != -1)
+    {
+      lg->ownerof[i] = i;
+      lg->live[SEGMENT_OF(i)]++;
+    }
+  }
+  lg->freecount = 0;
+  for (int segment = 0; segment < SWAPLOG_SEGMENTS; segment++)
+  {
+    lg->isfree[segment] = lg->live[segment] == 0;
+    if (lg->isfree[segment])
+      lg->freecount++;
+  }
+  lg->opensegment = -1;
+  lg->fill = 0;
+  lg->flushed = 0;
+  lg->stop = false;
+  memset(&(lg->stats), 0, sizeof(swaplogstats));
+  pthread_mutex_init(&(lg->lock), NULL);
+  pthread_cond_init(&(lg->needclean), NULL);
+  pthread_cond_init(&(lg->segmentfree), NULL);
+  if (pthread_create(&(lg->cleaner), NULL, cleaner_thread, (void *)lg) != 0)
+  {
+    fprintf(stderr, "[ERROR] failed to start the swap log cleaner\n");
+    pthread_mutex_destroy(&(lg->lock));
+    pthread_cond_destroy(&(lg->needclean));
+    pthread_cond_destroy(&(lg->segmentfree));
+    free(lg);
+    return NULL;
+  }
+  return lg;
+}
+
+// home_pages: puts the newest copy of every page back in its own slot and cuts the file to the fixed layout
+// the remap table dies with the log, a later run on the same file finds page n in slot n
+// called once the cleaner is stopped
+static bool home_pages(swaplog *lg)
+{
+  page *pages = (page *)malloc(sizeof(page) * PAGES);
+  const page *run[PAGES];
+  bool ok = true;
+  // every copy is read before any slot is overwritten, home slots may hold other pages
+  for (int i = 0; i < PAGES; i++)
+  {
+    ok = read_locked(lg, (uint16_t)i, pages + i) && ok;
+    run[i] = pages + i;
+  }
+  if (ok)
+  {
+    ok = write_slots(lg->ss, 0, run, PAGES) && resize_backingstore(lg->ss, PAGES);
+  }
+  if (!ok)
+  {
+    fprintf(stderr, "[ERROR] swaplog: failed to put pages back in their own slots\n");
+  }
+  free(pages);
+  return ok;
+}
+
+void free_swaplog(swaplog *lg)
+{
+  if (lg)
+  {
+    pthread_mutex_lock(&(lg->lock));
+    lg->stop = true;
+    pthread_cond_signal(&(lg->needclean));
+    pthread_mutex_unlock(&(lg->lock));
+    pthread_join(lg->cleaner, NULL);
+
+    // the open segment is read from its buffer, it needs no flush of its own
+    home_pages(lg);
+    pthread_mutex_destroy(&(lg->lock));
+    pthread_cond_destroy(&(lg->needclean));
+    pthread_cond_destroy(&(lg->segmentfree));
+    free(lg);
+  }
+}
+
+bool swaplog_append(swaplog *lg, const uint16_t vpn, const page *pages[], const int n)
+{
+  bool ok = true;
+  pthread_mutex_lock(&(lg->lock));
+  for (int i = 0; i < n; i++)
+  {
+    ok = append_page(lg, vpn + i, pages[i], false) && ok;
+  }
+  lg->stats.logicalwrites += n;
+  pthread_mutex_unlock(&(lg->lock));
+  return ok;
+}
+
+bool swaplog_read(swaplog *lg, const uint16_t vpn, page *pg)
+{
+  pthread_mutex_lock(&(lg->lock));
+  bool ok = read_locked(lg, vpn, pg);
+  pthread_mutex_unlock(&(lg->lock));
+  return ok;
+}
+
+bool swaplog_flush(swaplog *lg)
+{
+  pthread_mutex_lock(&(lg->lock));
+  bool ok = flush_open(lg);
+  pthread_mutex_unlock(&(lg->lock));
+  return ok;
+}
+
+void swaplog_discard(swaplog *lg, const uint16_t vpn)
+{
+  pthread_mutex_lock(&(lg->lock));
+  int slot = lg->slotof[vpn];
+  if (slot != -1)
+  {
+    // the copy is dead, the cleaner no longer has to move it
+    lg->ownerof[slot] = -1;
+    lg->live[SEGMENT_OF(slot)]--;
+    lg->slotof[vpn] = -1;
+  }
+  pthread_mutex_unlock(&(lg->lock));
+}
+
+void print_swaplogstats(swaplog *lg)
+{
+  pthread_mutex_lock(&(lg->lock));
+  const swaplogstats *stats = &(lg->stats);
+  printf("swap log segments: %d of %d pages, free: %d\n", SWAPLOG_SEGMENTS, SWAPLOG_SEGMENT_PAGES, lg->freecount);
+  printf("swap log writes: %lu logical, %lu physical in %lu sequential writes (avg %.2f pages)\n",
+         stats->logicalwrites,
+         stats->physicalwrites,
+         stats->writecalls,
+         stats->writecalls ? (double)stats->physicalwrites / stats->writecalls : 0.0);
+  printf("swap log cleaner: %lu segments cleaned, %lu pages relocated, %lu eviction stalls\n",
+         stats->cleaned,
+         stats->relocated,
+         stats->stalls);
+  // open segment pages not written yet count as neither
+  printf("swap log write amplification: %.2f\n",
+         stats->logicalwrites ? (double)stats->physicalwrites / stats->logicalwrites : 0.0);
+  pthread_mutex_unlock(&(lg->lock));
+}
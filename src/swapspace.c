@@ -6,7 +6,20 @@
 #include <errno.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <time.h>
 #include "swapspace.h"
+#include "writeback.h"
+#include "swapbackend.h"
+#include "zpool.h"
+#include "swaplog.h"
+#include "swapalloc.h"
+#include "swapdevs.h"
+
+// elapsed microseconds between two monotonic timestamps
+static double elapsed_us(const struct timespec *from, const struct timespec *to)
+{
+  return (double)(to->tv_sec - from->tv_sec) * 1e6 + (double)(to->tv_nsec - from->tv_nsec) / 1e3;
+}
 
 page new_page(void)
 {
@@ -18,20 +31,30 @@ page new_page(void)
   return newpage;
 }
 
-bool make_backingstore(swapspace *ss)
+// resize_backingstore: sets the size of the backing store file to nslots slots, the backend follows
+bool resize_backingstore(swapspace *ss, int nslots)
 {
-  size_t backingstore_size = PAGES * sizeof(page);
+  size_t oldsize = ss->size;
+  size_t backingstore_size = nslots * sizeof(page);
   errno = 0;
   if (ftruncate((int)ss->descriptor, backingstore_size) != 0)
   {
-    perror("make_backingstore");
+    perror("resize_backingstore");
     return false;
   }
 
-  munmap(ss->memorymap, ss->size);
   ss->size = backingstore_size;
-  ss->memorymap = mmap(NULL, backingstore_size, PROT_READ | PROT_WRITE, MAP_SHARED, ss->descriptor, 0);
-  for (int i = 0; i < PAGES; i++)
+  ss->nslots = nslots;
+  return ss->backend->resize(ss, oldsize);
+}
+
+bool make_backingstore(swapspace *ss, int nslots)
+{
+  if (!resize_backingstore(ss, nslots))
+  {
+    return false;
+  }
+  for (int i = 0; i < nslots; i++)
   {
     ss->memorymap[i] = new_page();
   }
@@ -40,7 +63,7 @@ bool make_backingstore(swapspace *ss)
   return true;
 }
 
-newswapspace new_swapspace(char *filename)
+newswapspace new_swapspace(char *filename, SWAPIO swapio, SWAPLAYOUT swaplayout)
 {
   newswapspace invalidreturn = {.isnew = false, .ss = NULL};
   // validate filename length
@@ -51,6 +74,17 @@ newswapspace new_swapspace(char *filename)
   }
   swapspace *ss = (swapspace *)malloc(sizeof(swapspace));
   strcpy(ss->filename, filename);
+  ss->wb = NULL;
+  ss->zp = NULL;
+  ss->log = NULL;
+  ss->alloc = NULL;
+  ss->devs = NULL;
+  // set by the simulator, nothing is synced while the swapspace is being set up
+  ss->durability = DURABILITY_NONE;
+  atomic_init(&(ss->syncs), 0);
+  memset(&(ss->iostats), 0, sizeof(swapiostats));
+  ss->backend = get_swapbackend(SWAPIO_MMAP);
+  ss->backenddata = NULL;
 
   // open backing store
   FILE *ss_store;
@@ -81,60 +115,327 @@ newswapspace new_swapspace(char *filename)
     printf("[INFO] swapspace already exists\n");
   }
 
+  // keep our own descriptor so the stdio stream can be closed properly
+  ss->descriptor = dup(fileno(ss_store));
+  fclose(ss_store);
+
   struct stat sb;
-  ss->descriptor = fileno(ss_store);
   if (fstat(ss->descriptor, &sb) == -1)
   {
 
     perror("could not get backing store stats");
     close(ss->descriptor);
-    free(ss_store);
     free(ss);
     return invalidreturn;
   }
 
   ss->memorymap = mmap(NULL, sb.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, ss->descriptor, 0);
   ss->size = sb.st_size;
+  ss->nslots = sb.st_size / sizeof(page);
+
+  // the log needs room for dead pages next to the live ones
+  // the compact layout starts with a single chunk and grows as pages get slots
+  int nslots = swaplayout == SWAPLAYOUT_LOG ? SWAPLOG_SLOTS : swaplayout == SWAPLAYOUT_COMPACT ? SWAPALLOC_CHUNK_SLOTS : PAGES;
+  if (!exists && !make_backingstore(ss, nslots))
+  {
+    free_swapspace(&ss);
+    return invalidreturn;
+  }
+  if (exists && ss->nslots < nslots && !resize_backingstore(ss, nslots))
+  {
+    free_swapspace(&ss);
+    return invalidreturn;
+  }
+
+  // the backing store is initialized through the mapping, from here on
+  // every transfer goes through the selected backend
+  const swapbackend *backend = get_swapbackend(swapio);
+  if (backend == NULL || !backend->open(ss))
+  {
+    fprintf(stderr, "[ERROR] failed to open the %s swap backend\n", backend ? backend->name : "unknown");
+    free_swapspace(&ss);
+    return invalidreturn;
+  }
+  ss->backend = backend;
+
+  // nothing is known about the slots of an existing swap file, all of them may hold data
+  memset(ss->backed, exists ? 0xff : 0, sizeof(ss->backed));
 
-  if (!exists && !make_backingstore(ss))
+  if (swaplayout == SWAPLAYOUT_LOG && (ss->log = new_swaplog(ss)) == NULL)
   {
-    free(ss_store);
     free_swapspace(&ss);
     return invalidreturn;
   }
+  if (swaplayout == SWAPLAYOUT_COMPACT)
+  {
+    ss->alloc = new_swapalloc(ss);
+  }
 
-  free(ss_store);
   newswapspace validreturn = {.isnew = !exists, .ss = ss};
   return validreturn;
 }
 
+// swapout_page: writes a page to the backing store, through the writeback if there is one
+static bool swapout_page(swapspace *ss, const uint16_t idx, const page *pg)
+{
+  if (ss->wb != NULL)
+  {
+    writeback_enqueue(ss->wb, idx, pg);
+    return true;
+  }
+  if (!store_pages(ss, idx, &pg, 1))
+  {
+    return false;
+  }
+  if (ss->durability == DURABILITY_EVERY_EVICT)
+  {
+    return sync_swapspace(ss, idx, 1);
+  }
+  return true;
+}
+
+// home_slots: puts every page of the compact layout back in its own slot and sizes the file to the fixed layout
+// the slot map dies with the allocator, a later run on the same file finds page n in slot n
+// a swapspace nothing was written through, an added swap device included, is left as it is
+static bool home_slots(swapspace *ss)
+{
+  bool written = false;
+  for (int i = 0; i < PAGES / 64 && !written; i++)
+  {
+    written = ss->backed[i] != 0;
+  }
+  if (!written)
+  {
+    return true;
+  }
+  page *pages = (page *)malloc(sizeof(page) * PAGES);
+  const page *run[PAGES];
+  bool ok = true;
+  // every page is read before any slot is overwritten, home slots may hold other pages
+  for (int i = 0; i < PAGES; i++)
+  {
+    if (ss->devs != NULL)
+      ok = swapdevs_read(ss->devs, (uint16_t)i, pages + i) && ok;
+    else
+      ok = swapalloc_read(ss->alloc, (uint16_t)i, pages + i) && ok;
+    run[i] = pages + i;
+  }
+  if (ok)
+  {
+    ok = resize_backingstore(ss, PAGES) && write_slots(ss, 0, run, PAGES);
+  }
+  if (!ok)
+  {
+    fprintf(stderr, "[ERROR] swapalloc: failed to put pages back in their own slots\n");
+  }
+  free(pages);
+  return ok;
+}
+
 void free_swapspace(swapspace **ss)
 {
   if (ss != NULL && (*ss) != NULL)
   {
-    munmap((*ss)->memorymap, (*ss)->size);
+    // pooled pages only live in memory, they go to swap like any other write
+    if ((*ss)->zp != NULL)
+    {
+      uint16_t idx;
+      page pg;
+      while (zpool_evict((*ss)->zp, &idx, &pg))
+      {
+        swapout_page(*ss, idx, &pg);
+      }
+      free_zpool((*ss)->zp);
+      (*ss)->zp = NULL;
+    }
+    // flush whatever is still queued before the mapping goes away
+    free_writeback((*ss)->wb);
+    free_swaplog((*ss)->log);
+    (*ss)->log = NULL;
+    if ((*ss)->alloc != NULL)
+    {
+      home_slots(*ss);
+    }
+    free_swapdevs((*ss)->devs, (*ss)->durability != DURABILITY_NONE);
+    (*ss)->devs = NULL;
+    // syncs below go straight to the backend
+    free_swapalloc((*ss)->alloc);
+    (*ss)->alloc = NULL;
+    if ((*ss)->durability != DURABILITY_NONE)
+    {
+      sync_swapspace(*ss, 0, (*ss)->nslots);
+    }
+    (*ss)->backend->close(*ss);
     close((*ss)->descriptor);
     free((*ss));
     *ss = NULL;
   }
 }
 
-page *get_pagecpy(const swapspace *ss, const uint16_t idx)
+page *get_pagecpy(swapspace *ss, const uint16_t idx)
 {
   page *pagecpy = (page *)malloc(sizeof(page));
-  memcpy(pagecpy, ss->memorymap + idx, sizeof(page));
+  // the pool holds the newest copy of whatever it stores
+  if (ss->zp != NULL && zpool_load(ss->zp, idx, pagecpy))
+  {
+    return pagecpy;
+  }
+  // a queued or in-flight writeback holds a newer copy than the backing store
+  if (ss->wb != NULL && writeback_lookup(ss->wb, idx, pagecpy))
+  {
+    return pagecpy;
+  }
+  bool ok;
+  if (ss->devs != NULL)
+    ok = swapdevs_read(ss->devs, idx, pagecpy);
+  else if (ss->log != NULL)
+    ok = swaplog_read(ss->log, idx, pagecpy);
+  else if (ss->alloc != NULL)
+    ok = swapalloc_read(ss->alloc, idx, pagecpy);
+  else
+    ok = read_slot(ss, idx, pagecpy);
+  if (!ok)
+  {
+    fprintf(stderr, "[ERROR] get_pagecpy: failed to read page %d, using a zero filled page\n", idx);
+    *pagecpy = new_page();
+  }
   return pagecpy;
 }
 
+bool read_slot(swapspace *ss, const uint16_t slot, page *pg)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool ok = ss->backend->read(ss, slot, pg);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ss->iostats.reads++;
+  ss->iostats.readtime += elapsed_us(&start, &end);
+  return ok;
+}
+
 bool write_page(swapspace *ss, const uint16_t idx, const page *pg)
 {
-  memcpy(ss->memorymap + idx, pg, sizeof(page));
-  return true;
+  ss->backed[idx >> 6] |= (uint64_t)1 << (idx & 63);
+  if (ss->zp == NULL || !zpool_store(ss->zp, idx, pg))
+  {
+    return swapout_page(ss, idx, pg);
+  }
+  // the pool is over budget, its oldest pages make room by going to swap
+  bool ok = true;
+  uint16_t victim;
+  page victimpg;
+  while (zpool_overbudget(ss->zp) && zpool_evict(ss->zp, &victim, &victimpg))
+  {
+    ok = swapout_page(ss, victim, &victimpg) && ok;
+  }
+  return ok;
+}
+
+void discard_swapcopy(swapspace *ss, const uint16_t idx)
+{
+  if (ss->zp != NULL)
+    zpool_invalidate(ss->zp, idx);
+  if (ss->log != NULL)
+    swaplog_discard(ss->log, idx);
+  if (ss->devs != NULL)
+    swapdevs_discard(ss->devs, idx);
+  else if (ss->alloc != NULL)
+    swapalloc_discard(ss->alloc, idx);
+}
+
+bool has_backingdata(const swapspace *ss, const uint16_t idx)
+{
+  return (ss->backed[idx >> 6] >> (idx & 63)) & 1;
+}
+
+bool store_pages(swapspace *ss, const uint16_t idx, const page *pages[], const int n)
+{
+  if (idx + n > PAGES)
+  {
+    fprintf(stderr, "[ERROR] store_pages: page run exceeds the swapspace\n");
+    return false;
+  }
+  if (ss->devs != NULL)
+  {
+    return swapdevs_store(ss->devs, idx, pages, n);
+  }
+  if (ss->log != NULL)
+  {
+    return swaplog_append(ss->log, idx, pages, n);
+  }
+  if (ss->alloc != NULL)
+  {
+    return swapalloc_store(ss->alloc, idx, pages, n);
+  }
+  return write_slots(ss, idx, pages, n);
 }
 
-bool validate_newswapspace(const swapspace *ss)
+bool write_slots(swapspace *ss, const uint16_t slot, const page *pages[], const int n)
 {
-  size_t expectedsize = sizeof(page) * PAGES;
+  if (slot + n > ss->nslots)
+  {
+    fprintf(stderr, "[ERROR] write_slots: slot run exceeds the backing store\n");
+    return false;
+  }
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool ok = ss->backend->write(ss, slot, pages, n);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ss->iostats.writes += n;
+  ss->iostats.writecalls++;
+  ss->iostats.writetime += elapsed_us(&start, &end);
+  return ok;
+}
+
+bool can_writeranges(const swapspace *ss)
+{
+  // every other layer either moves whole pages or moves a page to another slot on each write
+  return ss->wb == NULL && ss->zp == NULL && ss->log == NULL && ss->alloc == NULL && ss->devs == NULL;
+}
+
+// write_range: overwrites length bytes of page idx in place, starting at offset
+// expects can_writeranges, the rest of the slot must already hold the page
+bool write_range(swapspace *ss, const uint16_t idx, const int offset, const int length, const page *pg)
+{
+  if (offset < 0 || length <= 0 || offset + length > PAGESIZE)
+  {
+    fprintf(stderr, "[ERROR] write_range: range exceeds the page\n");
+    return false;
+  }
+  ss->backed[idx >> 6] |= (uint64_t)1 << (idx & 63);
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool ok = ss->backend->writebytes(ss, idx, offset, pg->content + offset, length);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ss->iostats.rangewrites++;
+  ss->iostats.writecalls++;
+  ss->iostats.writetime += elapsed_us(&start, &end);
+  return ok;
+}
+
+bool sync_swapspace(swapspace *ss, const uint16_t idx, const int n)
+{
+  atomic_fetch_add(&(ss->syncs), 1);
+  if (ss->log != NULL)
+  {
+    // pages do not live in their own slot, the open segment goes out and the whole file is synced
+    bool ok = swaplog_flush(ss->log);
+    return ss->backend->sync(ss, 0, ss->nslots) && ok;
+  }
+  if (ss->devs != NULL)
+  {
+    return swapdevs_sync(ss->devs);
+  }
+  if (ss->alloc != NULL)
+  {
+    return swapalloc_sync(ss->alloc);
+  }
+  return ss->backend->sync(ss, idx, n);
+}
+
+bool validate_newswapspace(swapspace *ss)
+{
+  size_t expectedsize = sizeof(page) * ss->nslots;
   printf("[INFO] expected size of the file: %zu\n", expectedsize);
   printf("[INFO] size of the file: %zu\n", ss->size);
   if (expectedsize != ss->size)
@@ -143,9 +444,13 @@ bool validate_newswapspace(const swapspace *ss)
     return false;
   }
 
-  for (int i = 0; i < PAGES; i++)
+  for (int i = 0; i < ss->nslots; i++)
   {
-    page sspage = ss->memorymap[i];
+    page sspage;
+    if (!ss->backend->read(ss, i, &sspage))
+    {
+      return false;
+    }
     for (int j = 0; j < PAGESIZE; j++)
     {
       if (sspage.content[j] != (char)0)
@@ -158,4 +463,21 @@ bool validate_newswapspace(const swapspace *ss)
 
   printf("[INFO] validated new swapspace\n");
   return true;
-}
\ No newline at end of file
+}
+
+void print_swapiostats(const swapspace *ss)
+{
+  const swapiostats *stats = &(ss->iostats);
+  printf("swap io backend: %s\n", ss->backend->name);
+  printf("swap io reads: %lu pages, avg %.2fus\n",
+         stats->reads,
+         stats->reads ? stats->readtime / stats->reads : 0.0);
+  printf("swap io writes: %lu pages in %lu calls, avg %.2fus per call\n",
+         stats->writes,
+         stats->writecalls,
+         stats->writecalls ? stats->writetime / stats->writecalls : 0.0);
+  if (stats->rangewrites != 0)
+  {
+    printf("swap io partial page writes: %lu\n", stats->rangewrites);
+  }
+}
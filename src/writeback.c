@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "writeback.h"
+
+// elapsed microseconds between two monotonic timestamps
+static double elapsed_us(const struct timespec *from, const struct timespec *to)
+{
+  return (double)(to->tv_sec - from->tv_sec) * 1e6 + (double)(to->tv_nsec - from->tv_nsec) / 1e3;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+  const writebackentry *lhs = (const writebackentry *)a;
+  const writebackentry *rhs = (const writebackentry *)b;
+  return (int)lhs->idx - (int)rhs->idx;
+}
+
+// flush_batch: writes the in-flight batch run by run, in every-evict mode it is synced with a single msync
+// called by the writeback thread without holding the lock, the batch is only read here
+static void flush_batch(writeback *wb)
+{
+  const page *run[PAGES];
+  int runs = 0;
+  int start = 0;
+  while (start < wb->batchsize)
+  {
+    // extend the run while swap slots stay contiguous
+    int end = start + 1;
+    while (end < wb->batchsize && wb->batch[end].idx == wb->batch[end - 1].idx + 1)
+    {
+      end++;
+    }
+    for (int i = start; i < end; i++)
+    {
+      run[i - start] = &(wb->batch[i].content);
+    }
+    store_pages(wb->ss, wb->batch[start].idx, run, end - start);
+    runs++;
+    start = end;
+  }
+
+  // end and periodic durability sync on their own schedule, not per batch
+  if (wb->ss->durability == DURABILITY_EVERY_EVICT)
+  {
+    uint16_t first = wb->batch[0].idx;
+    uint16_t last = wb->batch[wb->batchsize - 1].idx;
+    sync_swapspace(wb->ss, first, last - first + 1);
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  pthread_mutex_lock(&(wb->lock));
+  for (int i = 0; i < wb->batchsize; i++)
+  {
+    double latency = elapsed_us(&(wb->batch[i].queued), &now);
+    wb->stats.totallatency += latency;
+    if (latency > wb->stats.maxlatency)
+      wb->stats.maxlatency = latency;
+    wb->inflightpos[wb->batch[i].idx] = -1;
+  }
+  wb->stats.pagesflushed += wb->batchsize;
+  wb->stats.runs += runs;
+  wb->stats.batches++;
+  if (wb->batchsize > wb->stats.maxbatch)
+    wb->stats.maxbatch = wb->batchsize;
+  wb->batchsize = 0;
+  pthread_cond_broadcast(&(wb->idle));
+  pthread_mutex_unlock(&(wb->lock));
+}
+
+static void *writeback_thread(void *arg)
+{
+  writeback *wb = (writeback *)arg;
+  pthread_mutex_lock(&(wb->lock));
+  while (true)
+  {
+    while (wb->count == 0 && !wb->stop)
+    {
+      pthread_cond_wait(&(wb->notempty), &(wb->lock));
+    }
+    if (wb->count == 0 && wb->stop)
+    {
+      break;
+    }
+
+    // take everything that is queued as one batch
+    memcpy(wb->batch, wb->queue, sizeof(writebackentry) * wb->count);
+    wb->batchsize = wb->count;
+    wb->count = 0;
+    qsort(wb->batch, wb->batchsize, sizeof(writebackentry), compare_entries);
+    for (int i = 0; i < wb->batchsize; i++)
+    {
+      wb->pendingpos[wb->batch[i].idx] = -1;
+      wb->inflightpos[wb->batch[i].idx] = i;
+    }
+    pthread_cond_broadcast(&(wb->notfull));
+    pthread_mutex_unlock(&(wb->lock));
+
+    flush_batch(wb);
+
+    pthread_mutex_lock(&(wb->lock));
+  }
+  pthread_mutex_unlock(&(wb->lock));
+  return NULL;
+}
+
+writeback *new_writeback(swapspace *ss, int capacity)
+{
+  writeback *wb = (writeback *)malloc(sizeof(writeback));
+  wb->ss = ss;
+  wb->queue = (writebackentry *)malloc(sizeof(writebackentry) * capacity);
+  wb->batch = (writebackentry *)malloc(sizeof(writebackentry) * capacity);
+  wb->count = 0;
+  wb->batchsize = 0;
+  wb->capacity = capacity;
+  wb->stop = false;
+  memset(&(wb->stats), 0, sizeof(writebackstats));
+  for (int i = 0; i < PAGES; i++)
+  {
+    wb->pendingpos[i] = -1;
+    wb->inflightpos[i] = -1;
+  }
+  pthread_mutex_init(&(wb->lock), NULL);
+  pthread_cond_init(&(wb->notempty), NULL);
+  pthread_cond_init(&(wb->notfull), NULL);
+  pthread_cond_init(&(wb->idle), NULL);
+  if (pthread_create(&(wb->thread), NULL, writeback_thread, (void *)wb) != 0)
+  {
+    fprintf(stderr, "[ERROR] failed to start the writeback thread\n");
+    free(wb->queue);
+    free(wb->batch);
+    free(wb);
+    return NULL;
+  }
+  return wb;
+}
+
+void free_writeback(writeback *wb)
+{
+  if (wb)
+  {
+    pthread_mutex_lock(&(wb->lock));
+    wb->stop = true;
+    pthread_cond_signal(&(wb->notempty));
+    pthread_mutex_unlock(&(wb->lock));
+    pthread_join(wb->thread, NULL);
+
+    pthread_mutex_destroy(&(wb->lock));
+    pthread_cond_destroy(&(wb->notempty));
+    pthread_cond_destroy(&(wb->notfull));
+    pthread_cond_destroy(&(wb->idle));
+    free(wb->queue);
+    free(wb->batch);
+    free(wb);
+  }
+}
+
+void writeback_enqueue(writeback *wb, const uint16_t idx, const page *pg)
+{
+  pthread_mutex_lock(&(wb->lock));
+  int pos = wb->pendingpos[idx];
+  if (pos != -1)
+  {
+    // the page is still queued, the newer content simply replaces it
+    memcpy(&(wb->queue[pos].content), pg, sizeof(page));
+    wb->stats.coalesced++;
+    pthread_mutex_unlock(&(wb->lock));
+    return;
+  }
+
+  if (wb->count == wb->capacity)
+  {
+    // the only case in which an eviction waits on the writeback
+    wb->stats.stalls++;
+    while (wb->count == wb->capacity)
+    {
+      pthread_cond_wait(&(wb->notfull), &(wb->lock));
+    }
+  }
+
+  writebackentry *entry = wb->queue + wb->count;
+  entry->idx = idx;
+  memcpy(&(entry->content), pg, sizeof(page));
+  clock_gettime(CLOCK_MONOTONIC, &(entry->queued));
+  wb->pendingpos[idx] = wb->count;
+  wb->count++;
+
+  wb->stats.depthsamples++;
+  wb->stats.totaldepth += wb->count;
+  if (wb->count > wb->stats.maxdepth)
+    wb->stats.maxdepth = wb->count;
+
+  pthread_cond_signal(&(wb->notempty));
+  pthread_mutex_unlock(&(wb->lock));
+}
+
+bool writeback_lookup(writeback *wb, const uint16_t idx, page *pg)
+{
+  bool found = false;
+  pthread_mutex_lock(&(wb->lock));
+  if (wb->pendingpos[idx] != -1)
+  {
+    memcpy(pg, &(wb->queue[wb->pendingpos[idx]].content), sizeof(page));
+    found = true;
+  }
+  else if (wb->inflightpos[idx] != -1)
+  {
+    memcpy(pg, &(wb->batch[wb->inflightpos[idx]].content), sizeof(page));
+    found = true;
+  }
+  pthread_mutex_unlock(&(wb->lock));
+  return found;
+}
+
+void writeback_drain(writeback *wb)
+{
+  pthread_mutex_lock(&(wb->lock));
+  while (wb->count != 0 || wb->batchsize != 0)
+  {
+    pthread_cond_wait(&(wb->idle), &(wb->lock));
+  }
+  pthread_mutex_unlock(&(wb->lock));
+}
+
+void print_writebackstats(writeback *wb)
+{
+  writeback_drain(wb);
+  pthread_mutex_lock(&(wb->lock));
+  writebackstats *stats = &(wb->stats);
+  printf("writeback queue depth: %d\n", wb->capacity);
+  printf("writeback pages flushed: %lu (coalesced %lu)\n", stats->pagesflushed, stats->coalesced);
+  printf("writeback batches: %lu, runs: %lu, avg batch: %.2f, max batch: %d\n",
+         stats->batches,
+         stats->runs,
+         stats->batches ? (double)stats->pagesflushed / stats->batches : 0.0,
+         stats->maxbatch);
+  printf("writeback latency: avg %.2fus, max %.2fus\n",
+         stats->pagesflushed ? stats->totallatency / stats->pagesflushed : 0.0,
+         stats->maxlatency);
+  printf("writeback queue: avg depth %.2f, max depth %d, full-queue stalls %lu\n",
+         stats->depthsamples ? (double)stats->totaldepth / stats->depthsamples : 0.0,
+         stats->maxdepth,
+         stats->stalls);
+  pthread_mutex_unlock(&(wb->lock));
+}
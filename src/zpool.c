@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zpool.h"
+#include "compress.h"
+
+zpool *new_zpool(unsigned long budget)
+{
+  zpool *zp = (zpool *)malloc(sizeof(zpool));
+  zp->budget = budget;
+  zp->used = 0;
+  memset(zp->entries, 0, sizeof(zp->entries));
+  for (int i = 0; i < PAGES; i++)
+  {
+    zp->prev[i] = -1;
+    zp->next[i] = -1;
+  }
+  zp->oldest = -1;
+  zp->newest = -1;
+  zp->count = 0;
+  memset(&(zp->stats), 0, sizeof(zpoolstats));
+  return zp;
+}
+
+void free_zpool(zpool *zp)
+{
+  if (zp)
+  {
+    for (int i = 0; i < PAGES; i++)
+    {
+      free(zp->entries[i].data);
+    }
+    free(zp);
+  }
+}
+
+// zpool_unlink: drops the entry of idx, its compressed data included
+static void zpool_unlink(zpool *zp, const uint16_t idx)
+{
+  zpoolentry *entry = zp->entries + idx;
+  if (!entry->stored)
+  {
+    return;
+  }
+  if (zp->prev[idx] != -1)
+    zp->next[zp->prev[idx]] = zp->next[idx];
+  else
+    zp->oldest = zp->next[idx];
+  if (zp->next[idx] != -1)
+    zp->prev[zp->next[idx]] = zp->prev[idx];
+  else
+    zp->newest = zp->prev[idx];
+  zp->prev[idx] = -1;
+  zp->next[idx] = -1;
+
+  zp->used -= entry->size;
+  zp->count--;
+  free(entry->data);
+  entry->data = NULL;
+  entry->size = 0;
+  entry->stored = false;
+}
+
+bool zpool_store(zpool *zp, const uint16_t idx, const page *pg)
+{
+  // whatever the pool held for this slot is stale now
+  zpool_unlink(zp, idx);
+
+  zpoolentry *entry = zp->entries + idx;
+  uint8_t fill;
+  if (is_samefilled(pg, &fill))
+  {
+    // nothing to compress, the byte alone restores the page
+    entry->fill = fill;
+    zp->stats.samefilled++;
+    if (fill == 0)
+      zp->stats.zerofilled++;
+  }
+  else
+  {
+    uint8_t buffer[COMPRESS_BOUND];
+    int size = compress_page(pg, buffer);
+    if (size >= PAGESIZE)
+    {
+      zp->stats.rejected++;
+      return false;
+    }
+    entry->data = (uint8_t *)malloc(size);
+    memcpy(entry->data, buffer, size);
+    entry->size = (uint16_t)size;
+  }
+  entry->stored = true;
+
+  zp->prev[idx] = zp->newest;
+  if (zp->newest != -1)
+    zp->next[zp->newest] = idx;
+  else
+    zp->oldest = idx;
+  zp->newest = idx;
+
+  zp->used += entry->size;
+  zp->count++;
+  zp->stats.stores++;
+  zp->stats.bytesin += PAGESIZE;
+  zp->stats.bytesout += entry->size;
+  return true;
+}
+
+// zpool_restore: rebuilds the page held by a stored entry
+static bool zpool_restore(const zpoolentry *entry, page *pg)
+{
+  if (entry->data == NULL)
+  {
+    memset(pg->content, entry->fill, PAGESIZE);
+    return true;
+  }
+  return decompress_page(entry->data, entry->size, pg);
+}
+
+bool zpool_load(zpool *zp, const uint16_t idx, page *pg)
+{
+  const zpoolentry *entry = zp->entries + idx;
+  if (!entry->stored || !zpool_restore(entry, pg))
+  {
+    zp->stats.misses++;
+    return false;
+  }
+  zp->stats.hits++;
+  return true;
+}
+
+void zpool_invalidate(zpool *zp, const uint16_t idx)
+{
+  zpool_unlink(zp, idx);
+}
+
+bool zpool_overbudget(const zpool *zp)
+{
+  return zp->count > 0 && zp->used > zp->budget;
+}
+
+bool zpool_evict(zpool *zp, uint16_t *idx, page *pg)
+{
+  if (zp->oldest == -1)
+  {
+    return false;
+  }
+  *idx = (uint16_t)zp->oldest;
+  if (!zpool_restore(zp->entries + *idx, pg))
+  {
+    fprintf(stderr, "[ERROR] zpool_evict: corrupt entry for slot %d\n", *idx);
+    zpool_unlink(zp, *idx);
+    return false;
+  }
+  zpool_unlink(zp, *idx);
+  zp->stats.writebacks++;
+  return true;
+}
+
+void print_zpoolstats(const zpool *zp, const swapiostats *iostats)
+{
+  const zpoolstats *stats = &(zp->stats);
+  printf("zswap budget: %lu bytes, used: %lu bytes, pages held: %d\n", zp->budget, zp->used, zp->count);
+  printf("zswap stored: %lu (same-filled %lu, zero %lu), rejected: %lu\n",
+         stats->stores,
+         stats->samefilled,
+         stats->zerofilled,
+         stats->rejected);
+  printf("zswap compression ratio: %.2f (%lu -> %lu bytes)\n",
+         stats->bytesout ? (double)stats->bytesin / stats->bytesout : 0.0,
+         stats->bytesin,
+         stats->bytesout);
+  printf("zswap pool hits: %lu, misses: %lu, hit rate: %.2f%%\n",
+         stats->hits,
+         stats->misses,
+         stats->hits + stats->misses ? 100.0 * stats->hits / (stats->hits + stats->misses) : 0.0);
+  // every store the pool kept is a swap write that did not happen,
+  // every hit a swap read; what overflowed was written after all
+  printf("zswap written to swap on overflow: %lu\n", stats->writebacks);
+  printf("zswap swap io saved: %lu reads, %lu writes (swap did %lu reads, %lu writes)\n",
+         stats->hits,
+         stats->stores - stats->writebacks,
+         iostats->reads,
+         iostats->writes);
+}
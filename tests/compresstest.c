@@ -0,0 +1,72 @@
+#include <criterion/criterion.h>
+#include <criterion/new/assert.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "compress.h"
+
+// roundtrip: compresses pg, checks the size against expected and restores it
+static int roundtrip(const page *pg)
+{
+  uint8_t buffer[COMPRESS_BOUND];
+  page restored;
+  int size = compress_page(pg, buffer);
+  cr_assert(size > 0 && size <= COMPRESS_BOUND);
+  cr_assert(decompress_page(buffer, size, &restored));
+  cr_assert(memcmp(pg->content, restored.content, PAGESIZE) == 0);
+  return size;
+}
+
+Test(compress, zeropage)
+{
+  page pg;
+  uint8_t fill = 0xff;
+  memset(pg.content, 0, PAGESIZE);
+  cr_assert(is_samefilled(&pg, &fill));
+  cr_assert(fill == 0);
+  cr_assert(roundtrip(&pg) < 8);
+}
+
+Test(compress, samefilled)
+{
+  page pg;
+  uint8_t fill;
+  memset(pg.content, 0xab, PAGESIZE);
+  cr_assert(is_samefilled(&pg, &fill));
+  cr_assert(fill == 0xab);
+
+  pg.content[PAGESIZE - 1] = 0;
+  cr_assert(!is_samefilled(&pg, &fill));
+  roundtrip(&pg);
+}
+
+Test(compress, repeatingpattern)
+{
+  page pg;
+  for (int i = 0; i < PAGESIZE; i++)
+  {
+    pg.content[i] = (uint8_t)(i % 5);
+  }
+  cr_assert(roundtrip(&pg) < PAGESIZE / 4);
+}
+
+Test(compress, incompressible)
+{
+  page pg;
+  for (int i = 0; i < PAGESIZE; i++)
+  {
+    pg.content[i] = (uint8_t)i;
+  }
+  cr_assert(roundtrip(&pg) >= PAGESIZE);
+}
+
+Test(compress, corruptstream)
+{
+  page pg;
+  uint8_t truncated[] = {0x05, 1, 2};
+  uint8_t baddistance[] = {0x00, 7, 0x80, 2};
+  cr_assert(!decompress_page(truncated, sizeof(truncated), &pg));
+  cr_assert(!decompress_page(baddistance, sizeof(baddistance), &pg));
+}
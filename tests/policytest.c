@@ -0,0 +1,107 @@
+#include <criterion/criterion.h>
+#include <criterion/new/assert.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "memsimk.h"
+#include "memsimarg.h"
+
+#define TRACEFILE "policytest.txt"
+#define SWAPFILE "policytest.bin"
+#define OUTFILE "policytest.out"
+
+// pages referenced by the traces below, every reference is a read of the first byte of the page
+static const uint16_t belady[] = {1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5};
+static const uint16_t scan[] = {1, 2, 1, 2, 10, 11, 12, 13, 14, 15, 1, 2};
+static const uint16_t frequency[] = {1, 1, 1, 2, 2, 3, 4, 4, 5, 3, 1, 2, 4};
+static const uint16_t history[] = {1, 2, 3, 4, 1, 1, 1, 1, 2, 3, 4, 5, 1, 2};
+
+void setup(void)
+{
+  unlink(SWAPFILE);
+}
+
+void teardown(void)
+{
+  unlink(TRACEFILE);
+  unlink(SWAPFILE);
+  unlink(OUTFILE);
+}
+
+TestSuite(policy, .init = setup, .fini = teardown);
+
+// faults: runs the trace on level page tables with 4 frames and returns the demand page faults of algo
+static int faults(const char *algo, const char *level, const char *tick, const uint16_t *pages, int n)
+{
+  FILE *trace = fopen(TRACEFILE, "w");
+  cr_assert(trace != NULL);
+  for (int i = 0; i < n; i++)
+  {
+    fprintf(trace, "r 0x%04x\n", pages[i] << 6);
+  }
+  fclose(trace);
+
+  const char *argv[] = {"memsim", "-p", level, "-r", TRACEFILE, "-s", SWAPFILE,
+                        "-f", "4", "-a", algo, "-t", tick, "-o", OUTFILE};
+  cmd_args *args = new_cmdargs();
+  cr_assert(init_cmdargs(args, sizeof(argv) / sizeof(argv[0]), argv));
+  memsim *simulator = new_memsim(args);
+  cr_assert(simulator != NULL);
+  read_source(simulator, args->addrfile, args->tick);
+  int pagefaults = simulator->pagefaults;
+  free_memsim(simulator);
+  free_cmdargs(args);
+  unlink(SWAPFILE);
+  return pagefaults;
+}
+
+// the same counts come out of both page table types
+static void expect_faults(const char *algo, const char *tick, const uint16_t *pages, int n, int expected)
+{
+  cr_assert(faults(algo, "1", tick, pages, n) == expected);
+  cr_assert(faults(algo, "2", tick, pages, n) == expected);
+}
+
+#define NREFS(trace) ((int)(sizeof(trace) / sizeof(trace[0])))
+
+Test(policy, opt)
+{
+  // 5 evicts 4, the page used last, then 4 evicts one of the pages never used again
+  expect_faults("OPT", "1000", belady, NREFS(belady), 6);
+  // Belady's anomaly, FIFO does worse with 4 frames than the 9 faults it takes with 3
+  expect_faults("FIFO", "1000", belady, NREFS(belady), 10);
+}
+
+Test(policy, arc)
+{
+  // 1 and 2 are in T2 when the scan starts, the scan only replaces pages of T1
+  expect_faults("ARC", "1000", scan, NREFS(scan), 8);
+  // LRU lets the scan push 1 and 2 out
+  expect_faults("LRU", "1000", scan, NREFS(scan), 10);
+}
+
+Test(policy, lfu)
+{
+  // 5 evicts 3, referenced once, 3 then evicts 5, the only other page referenced once
+  expect_faults("LFU", "1000", frequency, NREFS(frequency), 6);
+}
+
+Test(policy, aging)
+{
+  // after two ticks of 4 references 1 is at 0xe0 and the others at 0x60, 5 evicts 2, the oldest of them,
+  // and 2 evicts 3, the referenced bits of the third tick are not counted yet
+  expect_faults("AGING", "4", history, NREFS(history), 6);
+  // LRU evicts 1, not referenced since the second tick, and has to bring it back
+  expect_faults("LRU", "4", history, NREFS(history), 7);
+}
+
+Test(policy, clockpro)
+{
+  // the cold hand turns 1 and 2 hot, referenced while on test, and evicts the scan pages only
+  expect_faults("CLOCKPRO", "1000", scan, NREFS(scan), 8);
+  // 5 evicts 3 and 3, back within its test period, evicts 5, neither was referenced after it came in
+  expect_faults("CLOCKPRO", "1000", frequency, NREFS(frequency), 6);
+}
@@ -0,0 +1,163 @@
+#include <criterion/criterion.h>
+#include <criterion/new/assert.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "swapspace.h"
+
+#define SWAPFILE "swaplayouttest.bin"
+
+// generation of the newest copy written of each page, 0 if the page was never written
+uint8_t generation[PAGES];
+
+void setup(void)
+{
+  unlink(SWAPFILE);
+  memset(generation, 0, sizeof(generation));
+}
+
+void teardown(void)
+{
+  unlink(SWAPFILE);
+}
+
+TestSuite(swaplayout, .init = setup, .fini = teardown);
+
+// content: copy gen of page idx, no two copies are alike and generation 0 is the zero page
+static page content(uint16_t idx, uint8_t gen)
+{
+  page pg = new_page();
+  if (gen == 0)
+    return pg;
+  for (int i = 0; i < PAGESIZE; i++)
+  {
+    pg.content[i] = (uint8_t)(idx + i * gen);
+  }
+  pg.content[0] = gen;
+  pg.content[1] = idx & 0xff;
+  pg.content[2] = idx >> 8;
+  return pg;
+}
+
+static void store(swapspace *ss, uint16_t idx, uint8_t gen)
+{
+  page pg = content(idx, gen);
+  cr_assert(write_page(ss, idx, &pg));
+  generation[idx] = gen;
+}
+
+// check: every page reads back as the newest copy written of it
+static void check(swapspace *ss)
+{
+  for (int idx = 0; idx < PAGES; idx++)
+  {
+    page expected = content(idx, generation[idx]);
+    page *pg = get_pagecpy(ss, idx);
+    cr_assert(memcmp(pg->content, expected.content, PAGESIZE) == 0);
+    free(pg);
+  }
+}
+
+// reopen: opens the file written before with layout through swapio and checks every page
+static void reopen(SWAPIO swapio, SWAPLAYOUT layout)
+{
+  newswapspace reopened = new_swapspace(SWAPFILE, swapio, layout);
+  cr_assert(reopened.ss != NULL && !reopened.isnew);
+  if (layout == SWAPLAYOUT_FIXED)
+    cr_assert(reopened.ss->nslots == PAGES);
+  check(reopened.ss);
+  free_swapspace(&(reopened.ss));
+}
+
+// roundtrip: stores pages out of order through layout and reads them back,
+// then reopens the file with layout and with the fixed layout, page n must be found in slot n
+// the file is resized along the way, every backend has to follow it
+static void roundtrip(SWAPIO swapio, SWAPLAYOUT layout, int rounds)
+{
+  newswapspace created = new_swapspace(SWAPFILE, swapio, layout);
+  cr_assert(created.ss != NULL && created.isnew);
+  swapspace *ss = created.ss;
+
+  // round r rewrites every r-th page, the pages are visited in a scattered order
+  for (int r = 1; r <= rounds; r++)
+  {
+    for (int i = 0; i < PAGES; i += r)
+    {
+      store(ss, (i * 37) % PAGES, r);
+    }
+  }
+  // a page overwritten with zeros must not come back with its old contents
+  store(ss, 37, 0);
+  check(ss);
+  free_swapspace(&ss);
+  cr_assert(ss == NULL);
+
+  reopen(swapio, layout);
+  reopen(swapio, SWAPLAYOUT_FIXED);
+}
+
+// sparse: only a few pages get slots, the compact file has to grow to the fixed layout at shutdown
+static void sparse(SWAPIO swapio)
+{
+  newswapspace created = new_swapspace(SWAPFILE, swapio, SWAPLAYOUT_COMPACT);
+  cr_assert(created.ss != NULL && created.isnew);
+  swapspace *ss = created.ss;
+  store(ss, 1000, 1);
+  store(ss, 5, 1);
+  store(ss, 600, 1);
+  store(ss, 5, 2);
+  check(ss);
+  free_swapspace(&ss);
+
+  reopen(swapio, SWAPLAYOUT_FIXED);
+}
+
+// more writes than the log has slots, the cleaner has to reclaim segments
+Test(swaplayout, log)
+{
+  roundtrip(SWAPIO_MMAP, SWAPLAYOUT_LOG, 4);
+}
+
+Test(swaplayout, log_pread)
+{
+  roundtrip(SWAPIO_PREAD, SWAPLAYOUT_LOG, 4);
+}
+
+Test(swaplayout, log_direct)
+{
+  roundtrip(SWAPIO_DIRECT, SWAPLAYOUT_LOG, 4);
+}
+
+Test(swaplayout, compact)
+{
+  roundtrip(SWAPIO_MMAP, SWAPLAYOUT_COMPACT, 3);
+}
+
+Test(swaplayout, compact_pread)
+{
+  roundtrip(SWAPIO_PREAD, SWAPLAYOUT_COMPACT, 3);
+}
+
+Test(swaplayout, compact_direct)
+{
+  roundtrip(SWAPIO_DIRECT, SWAPLAYOUT_COMPACT, 3);
+}
+
+Test(swaplayout, compact_sparse)
+{
+  sparse(SWAPIO_MMAP);
+}
+
+Test(swaplayout, compact_sparse_pread)
+{
+  sparse(SWAPIO_PREAD);
+}
+
+Test(swaplayout, compact_sparse_direct)
+{
+  sparse(SWAPIO_DIRECT);
+}